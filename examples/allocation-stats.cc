@@ -0,0 +1,246 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "allocation-stats.h"
+
+// Without --enable-laa-allocation-stats nothing is replaced, so that the
+// scenarios use the allocator of the C library and can be run under
+// memory checkers such as valgrind or AddressSanitizer.
+#ifdef LAA_ALLOCATION_STATS
+
+#include <cstdlib>
+#include <new>
+
+// Allocations of up to MAX_POOLED_SIZE bytes are served from free lists,
+// one per size class (multiple of POOL_GRANULARITY bytes), refilled with
+// POOL_REFILL_BYTES from malloc () at a time; pooled blocks are never
+// returned to malloc ().  Every block is preceded by a header holding
+// its size class, N_SIZE_CLASSES for the larger blocks allocated with
+// malloc (), so that operator delete knows where the block goes.  The
+// header is as large as the alignment of malloc (), which is preserved.
+static const std::size_t POOL_GRANULARITY = 16;
+static const std::size_t MAX_POOLED_SIZE = 512;
+static const std::size_t N_SIZE_CLASSES = MAX_POOLED_SIZE / POOL_GRANULARITY;
+static const std::size_t POOL_REFILL_BYTES = 64 * 1024;
+static const std::size_t HEADER_SIZE = 16;
+
+struct FreeBlock
+{
+  FreeBlock *next;
+};
+
+// The free lists are per thread, so that they need no locking; a block
+// freed by another thread than the one which allocated it is simply
+// reused by the former.
+#if defined (__GNUC__)
+static __thread FreeBlock *g_freeLists[N_SIZE_CLASSES];
+#else
+static FreeBlock *g_freeLists[N_SIZE_CLASSES];
+#endif
+
+static uint64_t g_heapAllocationCount = 0;
+static uint64_t g_heapAllocatedBytes = 0;
+
+static FreeBlock *
+RefillPool (std::size_t sizeClass)
+{
+  std::size_t blockSize = HEADER_SIZE + (sizeClass + 1) * POOL_GRANULARITY;
+  std::size_t nBlocks = POOL_REFILL_BYTES / blockSize;
+  char *chunk = static_cast<char *> (std::malloc (nBlocks * blockSize));
+  if (chunk == 0)
+    {
+      return 0;
+    }
+  // the headers are written once, here; link the blocks so that they
+  // are handed out in address order
+  FreeBlock *head = 0;
+  for (std::size_t i = nBlocks; i > 0; --i)
+    {
+      char *block = chunk + (i - 1) * blockSize;
+      *reinterpret_cast<std::size_t *> (block) = sizeClass;
+      FreeBlock *freeBlock = reinterpret_cast<FreeBlock *> (block + HEADER_SIZE);
+      freeBlock->next = head;
+      head = freeBlock;
+    }
+  return head;
+}
+
+static void *
+PoolAllocate (std::size_t size)
+{
+  // atomic, since the standard library or ns-3 might allocate from
+  // other threads
+#if defined (__GNUC__)
+  __sync_fetch_and_add (&g_heapAllocationCount, 1);
+  __sync_fetch_and_add (&g_heapAllocatedBytes, size);
+#else
+  ++g_heapAllocationCount;
+  g_heapAllocatedBytes += size;
+#endif
+  if (size == 0)
+    {
+      size = 1;
+    }
+  if (size <= MAX_POOLED_SIZE)
+    {
+      std::size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+      FreeBlock *block = g_freeLists[sizeClass];
+      if (block == 0)
+        {
+          block = RefillPool (sizeClass);
+          if (block == 0)
+            {
+              return 0;
+            }
+        }
+      g_freeLists[sizeClass] = block->next;
+      return block;
+    }
+  char *block = static_cast<char *> (std::malloc (HEADER_SIZE + size));
+  if (block == 0)
+    {
+      return 0;
+    }
+  *reinterpret_cast<std::size_t *> (block) = N_SIZE_CLASSES;
+  return block + HEADER_SIZE;
+}
+
+static void
+PoolFree (void *p)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  char *block = static_cast<char *> (p) - HEADER_SIZE;
+  std::size_t sizeClass = *reinterpret_cast<std::size_t *> (block);
+  if (sizeClass == N_SIZE_CLASSES)
+    {
+      std::free (block);
+      return;
+    }
+  FreeBlock *freeBlock = static_cast<FreeBlock *> (p);
+  freeBlock->next = g_freeLists[sizeClass];
+  g_freeLists[sizeClass] = freeBlock;
+}
+
+static void *
+Allocate (std::size_t size)
+{
+  void *p = PoolAllocate (size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+// operator new[] and operator delete[] are implemented by the standard
+// library in terms of operator new and operator delete, so they need
+// not be replaced; the nothrow versions are, since some versions of the
+// standard library implement them with malloc () and free ().
+#if __cplusplus >= 201103L
+void *
+operator new (std::size_t size)
+{
+  return Allocate (size);
+}
+
+void *
+operator new (std::size_t size, const std::nothrow_t &) noexcept
+{
+  return PoolAllocate (size);
+}
+
+void
+operator delete (void *p) noexcept
+{
+  PoolFree (p);
+}
+
+void
+operator delete (void *p, const std::nothrow_t &) noexcept
+{
+  PoolFree (p);
+}
+
+#if defined (__cpp_sized_deallocation)
+void
+operator delete (void *p, std::size_t) noexcept
+{
+  PoolFree (p);
+}
+#endif
+#else
+void *
+operator new (std::size_t size) throw (std::bad_alloc)
+{
+  return Allocate (size);
+}
+
+void *
+operator new (std::size_t size, const std::nothrow_t &) throw ()
+{
+  return PoolAllocate (size);
+}
+
+void
+operator delete (void *p) throw ()
+{
+  PoolFree (p);
+}
+
+void
+operator delete (void *p, const std::nothrow_t &) throw ()
+{
+  PoolFree (p);
+}
+#endif
+
+#endif /* LAA_ALLOCATION_STATS */
+
+bool
+IsHeapAllocationCounted (void)
+{
+#ifdef LAA_ALLOCATION_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint64_t
+GetHeapAllocationCount (void)
+{
+#ifdef LAA_ALLOCATION_STATS
+  return g_heapAllocationCount;
+#else
+  return 0;
+#endif
+}
+
+uint64_t
+GetHeapAllocatedBytes (void)
+{
+#ifdef LAA_ALLOCATION_STATS
+  return g_heapAllocatedBytes;
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,49 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LAA_ALLOCATION_STATS_H
+#define LAA_ALLOCATION_STATS_H
+
+#include <stdint.h>
+
+// If the module was configured with --enable-laa-allocation-stats, the
+// scenario programs replace the global operator new and operator delete
+// with versions that serve the small allocations from per-size free
+// lists and count the calls, so that the heap activity of a simulation
+// can be reported without an external profiler.  Otherwise the
+// allocator of the C library is used.
+
+/**
+ * \return true if the calls to operator new are counted
+ */
+bool IsHeapAllocationCounted (void);
+
+/**
+ * \return the number of calls to operator new since the program
+ * started, or 0 if they are not counted
+ */
+uint64_t GetHeapAllocationCount (void);
+
+/**
+ * \return the number of bytes requested to operator new since the
+ * program started, or 0 if they are not counted
+ */
+uint64_t GetHeapAllocatedBytes (void);
+
+#endif
@@ -185,6 +185,11 @@ static ns3::GlobalValue g_ftpLambda ("ftpLambda",
                                     ns3::DoubleValue (0.5),
                                     ns3::MakeDoubleChecker<double> ());
 
+static ns3::GlobalValue g_numUePerCell ("numUePerCell",
+                                        "Number of UEs per cell, for both operators",
+                                        ns3::UintegerValue (5),
+                                        ns3::MakeUintegerChecker<uint32_t> (1));
+
 static ns3::GlobalValue g_generateRem ("generateRem",
                                        "if true, will generate a REM and then abort the simulation;"
                                        "if false, will run the simulation normally (without generating any REM)",
@@ -210,9 +215,11 @@ main (int argc, char *argv[])
   cmd.Parse (argc, argv);
 
   // This program has two operators, and nominally 4 cells per operator
-  // and 5 UEs per cell.  These variables can be tuned below for
-  // e.g. debugging on a smaller scale scenario
-  uint32_t numUePerCell = 5;
+  // and 5 UEs per cell (global value numUePerCell).  These variables
+  // can be tuned below for e.g. debugging on a smaller scale scenario
+  UintegerValue uintegerValue;
+  GlobalValue::GetValueByName ("numUePerCell", uintegerValue);
+  uint32_t numUePerCell = uintegerValue.Get ();
   uint32_t numCells = 4;
 
   // Some debugging settings not exposed as command line args are below
@@ -0,0 +1,215 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+// Compare the cost of the DL scheduling of PfFfMacScheduler and
+// IncrementalPfFfMacScheduler.
+//
+// Each scheduler is driven through its SAPs, without the rest of the LTE
+// stack, on a 100 RB cell shared by nUes UEs with full buffers.  Every
+// cqiPeriod TTIs, each UE reports subband (A30) CQIs drawn between 1 and
+// 15.  The program prints the time per TTI of each scheduler, and checks
+// that they make the same allocations.  For example:
+//
+//   for n in 10 20 30 40 50; do ./waf --run "lte-scheduler-benchmark --nUes=$n"; done
+
+#include <ns3/core-module.h>
+#include <ns3/lte-module.h>
+#include <ns3/incremental-pf-ff-mac-scheduler.h>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+// The SAP users of a scheduler, which record its DL allocations
+class BenchmarkSapUser : public FfMacCschedSapUser, public FfMacSchedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    for (uint32_t k = 0; k < params.m_buildDataList.size (); ++k)
+      {
+        const DlDciListElement_s &dci = params.m_buildDataList[k].m_dci;
+        m_allocations.push_back (dci.m_rnti);
+        m_allocations.push_back (dci.m_rbBitmap);
+        for (uint32_t j = 0; j < dci.m_tbsSize.size (); ++j)
+          {
+            m_allocations.push_back (dci.m_tbsSize[j]);
+          }
+      }
+    // no UE has RNTI 0: it ends the TTI
+    m_allocations.push_back (0);
+  }
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+  {
+  }
+
+  std::vector<uint32_t> m_allocations; ///< the RNTIs, RBGs and TB sizes allocated
+};
+
+// Run the benchmark on a scheduler, and return its allocations
+std::vector<uint32_t>
+RunBenchmark (Ptr<FfMacScheduler> scheduler, uint16_t nUes,
+              const std::vector<FfMacSchedSapProvider::SchedDlCqiInfoReqParameters> &cqiReports,
+              int64_t &elapsedMs)
+{
+  const uint8_t bandwidth = 100;
+  BenchmarkSapUser sapUser;
+  Ptr<LteFfrAlgorithm> ffr = CreateObject<LteFrNoOpAlgorithm> ();
+  ffr->SetDlBandwidth (bandwidth);
+  ffr->SetUlBandwidth (bandwidth);
+  ffr->SetLteFfrSapUser (scheduler->GetLteFfrSapUser ());
+  scheduler->SetLteFfrSapProvider (ffr->GetLteFfrSapProvider ());
+  scheduler->SetFfMacCschedSapUser (&sapUser);
+  scheduler->SetFfMacSchedSapUser (&sapUser);
+  scheduler->SetAttribute ("HarqEnabled", BooleanValue (false));
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cell;
+  cell.m_dlBandwidth = bandwidth;
+  cell.m_ulBandwidth = bandwidth;
+  scheduler->GetFfMacCschedSapProvider ()->CschedCellConfigReq (cell);
+  for (uint16_t rnti = 1; rnti <= nUes; ++rnti)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ue;
+      ue.m_rnti = rnti;
+      ue.m_transmissionMode = 0;
+      scheduler->GetFfMacCschedSapProvider ()->CschedUeConfigReq (ue);
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lc;
+      lc.m_rnti = rnti;
+      lc.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lcConfig;
+      lcConfig.m_logicalChannelIdentity = 3;
+      lcConfig.m_logicalChannelGroup = 1;
+      lcConfig.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lcConfig.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lcConfig.m_qci = 9;
+      lc.m_logicalChannelConfigList.push_back (lcConfig);
+      scheduler->GetFfMacCschedSapProvider ()->CschedLcConfigReq (lc);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t tti = 0; tti < cqiReports.size (); ++tti)
+    {
+      // the buffers are refilled as RLC would do with a full buffer source
+      for (uint16_t rnti = 1; rnti <= nUes; ++rnti)
+        {
+          FfMacSchedSapProvider::SchedDlRlcBufferReqParameters buffer;
+          buffer.m_rnti = rnti;
+          buffer.m_logicalChannelIdentity = 3;
+          buffer.m_rlcTransmissionQueueSize = 100000;
+          buffer.m_rlcTransmissionQueueHolDelay = 0;
+          buffer.m_rlcRetransmissionQueueSize = 0;
+          buffer.m_rlcRetransmissionHolDelay = 0;
+          buffer.m_rlcStatusPduSize = 0;
+          scheduler->GetFfMacSchedSapProvider ()->SchedDlRlcBufferReq (buffer);
+        }
+      if (!cqiReports[tti].m_cqiList.empty ())
+        {
+          scheduler->GetFfMacSchedSapProvider ()->SchedDlCqiInfoReq (cqiReports[tti]);
+        }
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters trigger;
+      trigger.m_sfnSf = cqiReports[tti].m_sfnSf;
+      scheduler->GetFfMacSchedSapProvider ()->SchedDlTriggerReq (trigger);
+    }
+  elapsedMs = clock.End ();
+
+  scheduler->Dispose ();
+  ffr->Dispose ();
+  return sapUser.m_allocations;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint16_t nUes = 20;
+  uint32_t nTtis = 2000;
+  uint32_t cqiPeriod = 10;
+
+  CommandLine cmd;
+  cmd.AddValue ("nUes", "number of UEs", nUes);
+  cmd.AddValue ("nTtis", "number of TTIs scheduled", nTtis);
+  cmd.AddValue ("cqiPeriod", "TTIs between two CQI reports of a UE", cqiPeriod);
+  cmd.Parse (argc, argv);
+
+  // the CQIs are drawn in advance, so that only the schedulers are timed
+  const uint32_t rbgNum = 25;
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<FfMacSchedSapProvider::SchedDlCqiInfoReqParameters> cqiReports (nTtis);
+  for (uint32_t tti = 0; tti < nTtis; ++tti)
+    {
+      cqiReports[tti].m_sfnSf = ((1 + tti / 10) << 4) | (1 + tti % 10);
+      for (uint16_t rnti = 1; rnti <= nUes; ++rnti)
+        {
+          if ((tti + rnti) % cqiPeriod != 0)
+            {
+              continue;
+            }
+          CqiListElement_s cqi;
+          cqi.m_rnti = rnti;
+          cqi.m_ri = 1;
+          cqi.m_cqiType = CqiListElement_s::A30;
+          for (uint32_t j = 0; j < rbgNum; ++j)
+            {
+              HigherLayerSelected_s subband;
+              subband.m_sbCqi.push_back (random->GetInteger (1, 15));
+              cqi.m_sbMeasResult.m_higherLayerSelected.push_back (subband);
+            }
+          cqiReports[tti].m_cqiList.push_back (cqi);
+        }
+    }
+
+  int64_t elapsedMs;
+  std::vector<uint32_t> expected = RunBenchmark (CreateObject<PfFfMacScheduler> (), nUes, cqiReports, elapsedMs);
+  std::cout << "PfFfMacScheduler: " << nTtis << " TTIs in " << elapsedMs << " ms ("
+            << 1000.0 * elapsedMs / nTtis << " us per TTI)" << std::endl;
+
+  std::vector<uint32_t> allocations = RunBenchmark (CreateObject<IncrementalPfFfMacScheduler> (), nUes, cqiReports, elapsedMs);
+  std::cout << "IncrementalPfFfMacScheduler: " << nTtis << " TTIs in " << elapsedMs << " ms ("
+            << 1000.0 * elapsedMs / nTtis << " us per TTI)" << std::endl;
+
+  if (allocations != expected)
+    {
+      std::cout << "WARNING: different allocations" << std::endl;
+      return 1;
+    }
+  return 0;
+}
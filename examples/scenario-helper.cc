@@ -20,6 +20,7 @@
  */
 
 #include "scenario-helper.h"
+#include "allocation-stats.h"
 #include <ns3/core-module.h>
 #include <ns3/network-module.h>
 #include <ns3/internet-module.h>
@@ -32,6 +33,14 @@
 #include <ns3/propagation-module.h>
 #include <ns3/config-store-module.h>
 #include <ns3/flow-monitor-module.h>
+#include <ns3/coexistence-spectrum-channel.h>
+#include <ns3/counting-scheduler.h>
+#include <ns3/multi-destination-udp-client.h>
+#include <ns3/full-buffer-wifi-source.h>
+#include <ns3/lte-mi-cache.h>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 
 using namespace ns3;
 
@@ -66,6 +75,113 @@ static ns3::GlobalValue g_remDir ("remDir",
                                   ns3::StringValue ("./"),
                                   ns3::MakeStringChecker ());
 
+static ns3::GlobalValue g_spectrumChannelType ("spectrumChannelType",
+                                               "TypeId of the SpectrumChannel shared by LTE and Wi-Fi; "
+                                               "ns3::CoexistenceSpectrumChannel shares one copy of each signal among all receivers, "
+                                               "ns3::MultiModelSpectrumChannel copies it for every receiver",
+                                               ns3::StringValue ("ns3::MultiModelSpectrumChannel"),
+                                               ns3::MakeStringChecker ());
+
+static ns3::GlobalValue g_allocationStats ("allocationStats",
+                                           "if true, the number of heap allocations and allocated bytes "
+                                           "in every simulated second are saved to a file with suffix _allocations; "
+                                           "needs the module configured with --enable-laa-allocation-stats",
+                                           ns3::BooleanValue (false),
+                                           ns3::MakeBooleanChecker ());
+
+static ns3::GlobalValue g_errorRateTableFile ("errorRateTableFile",
+                                              "if not empty, Wi-Fi devices use ns3::TableErrorRateModel with the "
+                                              "tables memory-mapped from this file (created if missing), which can "
+                                              "be shared by all the processes of a simulation campaign",
+                                              ns3::StringValue (""),
+                                              ns3::MakeStringChecker ());
+
+static ns3::GlobalValue g_fadingTraceFile ("fadingTraceFile",
+                                           "if not empty, frequency-selective fading is applied to all the LTE and "
+                                           "Wi-Fi links with ns3::MmapTraceFadingLossModel, using the trace memory-mapped "
+                                           "from this file, which can be shared by all the processes of a simulation campaign",
+                                           ns3::StringValue (""),
+                                           ns3::MakeStringChecker ());
+
+static ns3::GlobalValue g_reducedSignalling ("reducedSignalling",
+                                             "if true and the spectrum channel is ns3::CoexistenceSpectrumChannel, "
+                                             "the LTE DL control frames followed by a data frame are folded "
+                                             "into it for the Wi-Fi receivers",
+                                             ns3::BooleanValue (false),
+                                             ns3::MakeBooleanChecker ());
+
+static ns3::GlobalValue g_measurementCells ("measurementCells",
+                                            "if not 0, with ns3::CoexistenceSpectrumChannel, the number of "
+                                            "cells of its CSG measured by each UE, those with the highest "
+                                            "RSRP computed at setup",
+                                            ns3::UintegerValue (0),
+                                            ns3::MakeUintegerChecker<uint32_t> ());
+
+static ns3::GlobalValue g_directAttach ("directAttach",
+                                        "if true, with ns3::CoexistenceSpectrumChannel, each UE is attached "
+                                        "to the eNB of its CSG with the highest RSRP computed at setup, "
+                                        "instead of simulating the initial cell selection",
+                                        ns3::BooleanValue (false),
+                                        ns3::MakeBooleanChecker ());
+
+static ns3::GlobalValue g_oracleWifiAssociation ("oracleWifiAssociation",
+                                                 "if true, with ns3::CoexistenceSpectrumChannel, each STA can only "
+                                                 "associate with the AP of its SSID with the highest RSS computed at "
+                                                 "setup, and its routes are installed at time zero",
+                                                 ns3::BooleanValue (false),
+                                                 ns3::MakeBooleanChecker ());
+
+static ns3::GlobalValue g_cullBeacons ("cullBeacons",
+                                       "if true, with ns3::CoexistenceSpectrumChannel, the beacons are not "
+                                       "delivered to associated STAs",
+                                       ns3::BooleanValue (false),
+                                       ns3::MakeBooleanChecker ());
+
+static ns3::GlobalValue g_wifiRemoteStationManager ("wifiRemoteStationManager",
+                                                    "the ns3::WifiRemoteStationManager of the APs and STAs; "
+                                                    "ns3::ThresholdIdealWifiManager selects the same modes as "
+                                                    "ns3::IdealWifiManager with a cached table lookup",
+                                                    ns3::StringValue ("ns3::IdealWifiManager"),
+                                                    ns3::MakeStringChecker ());
+
+static ns3::GlobalValue g_aggregatedUdpClient ("aggregatedUdpClient",
+                                               "if true, each client node sends the UDP traffic to all its UEs "
+                                               "with a single ns3::MultiDestinationUdpClient instead of a "
+                                               "ns3::UdpClient per UE",
+                                               ns3::BooleanValue (false),
+                                               ns3::MakeBooleanChecker ());
+
+static ns3::GlobalValue g_fullBuffer ("fullBuffer",
+                                      "if true, the eNBs and APs always have data to send to all their UEs, "
+                                      "generated below the IP layer (RLC SM for LTE, ns3::FullBufferWifiSource "
+                                      "for Wi-Fi) instead of by the applications",
+                                      ns3::BooleanValue (false),
+                                      ns3::MakeBooleanChecker ());
+
+static ns3::GlobalValue g_lteSchedulerType ("lteSchedulerType",
+                                            "the ns3::FfMacScheduler used by the eNBs, e.g., ns3::IncrementalPfFfMacScheduler",
+                                            ns3::StringValue ("ns3::PfFfMacScheduler"),
+                                            ns3::MakeStringChecker ());
+
+static ns3::GlobalValue g_lteCqiCacheStats ("lteCqiCacheStats",
+                                            "if true, the hit rate an ns3::LteMiCache with step lteMiCacheQuantization "
+                                            "would have for the DL CQIs of the LTE UEs is estimated from the SINR of the "
+                                            "data they receive, without evaluating the CQIs, and printed after the run",
+                                            ns3::BooleanValue (false),
+                                            ns3::MakeBooleanChecker ());
+
+static ns3::GlobalValue g_lteMiCacheQuantization ("lteMiCacheQuantization",
+                                                  "SINR quantization step (dB) of the ns3::LteMiCache used "
+                                                  "with lteCqiCacheStats; 0 for the exact mode",
+                                                  ns3::DoubleValue (0),
+                                                  ns3::MakeDoubleChecker<double> (0));
+
+static ns3::GlobalValue g_countSchedulerOperations ("countSchedulerOperations",
+                                                    "if true, the operations on the event queue are counted by "
+                                                    "ns3::CountingScheduler and printed after the run",
+                                                    ns3::BooleanValue (false),
+                                                    ns3::MakeBooleanChecker ());
+
 // Parse context strings of the form "/NodeList/3/DeviceList/1/Mac/Assoc"
 // to extract the NodeId
 uint32_t
@@ -178,27 +294,19 @@ GetRemoteDevice (Ptr<Node> ap, Ptr<PointToPointNetDevice> p2p)
 }
 
 void
-ConfigureRouteForStation (std::string context, Mac48Address address)
+InstallRoutesForStation (Ptr<Node> myNode, Ptr<NetDevice> myNd, Ptr<Node> ap)
 {
-  // We receive the context string of the STA that has just associated
-  // and the BSSID of the AP in the 'address' parameter.
   // We need to install the IP address of the AP as this STA's default
   // route.  We need to install the IP address of the AP's point-to-point
   // interface with the client node, as a next hop host route to this STA.
 
   // Step 1: Obtain STA IP address
-  NS_LOG_DEBUG ("ConfigureRouteForStation: " << context << " " << address);
-  uint32_t myNodeId = ContextToNodeId (context);
-  Ptr<Node> myNode = NodeContainer::GetGlobal ().Get (myNodeId);
-  uint32_t myDeviceId = ContextToDeviceId (context);
   Ptr<Ipv4> myIp = myNode->GetObject<Ipv4> ();
-  Ptr<NetDevice> myNd = myNode->GetDevice (myDeviceId);
   int32_t myIface = myIp->GetInterfaceForDevice (myNd);
   Ipv4InterfaceAddress myAddr = myIp->GetAddress (myIface, 0);
   NS_LOG_DEBUG ("STA IP address is: " << myAddr.GetLocal ());
 
   // Step 2: Install default route to AP on STA
-  Ptr<Node> ap = MacAddressToNode (address);
   Ptr<WifiNetDevice> wifi = FindFirstWifiNetDevice (ap);
   Ptr<Ipv4> ip = ap->GetObject<Ipv4> ();
   int32_t iface = ip->GetInterfaceForDevice (wifi);
@@ -221,6 +329,82 @@ ConfigureRouteForStation (std::string context, Mac48Address address)
   NS_LOG_DEBUG ("Setting client host route to " << myAddr.GetLocal () << " to nextHop " << apAddr << " " << iface);
 }
 
+void
+ConfigureRouteForStation (std::string context, Mac48Address address)
+{
+  // We receive the context string of the STA that has just associated
+  // and the BSSID of the AP in the 'address' parameter.
+  NS_LOG_DEBUG ("ConfigureRouteForStation: " << context << " " << address);
+  uint32_t myNodeId = ContextToNodeId (context);
+  Ptr<Node> myNode = NodeContainer::GetGlobal ().Get (myNodeId);
+  uint32_t myDeviceId = ContextToDeviceId (context);
+  InstallRoutesForStation (myNode, myNode->GetDevice (myDeviceId), MacAddressToNode (address));
+}
+
+// In the beacon-culling mode, a STA stops receiving beacons once it has
+// associated, and starts again if it loses the association
+void
+CullBeaconsOfStation (Ptr<CoexistenceSpectrumChannel> channel, bool cull, std::string context, Mac48Address address)
+{
+  uint32_t nodeId = ContextToNodeId (context);
+  Ptr<Node> node = NodeContainer::GetGlobal ().Get (nodeId);
+  channel->SetBeaconCulling (node->GetDevice (ContextToDeviceId (context)), cull);
+}
+
+// Oracle association: each STA is assigned to the AP of its SSID with
+// the highest RSS, computed at setup from the losses of the channel
+// (all the APs transmit with the same power and gains), and its routes
+// are installed right away.  Each AP gets its own SSID, which is also
+// given to the STAs assigned to it, so that the scanning of the STAs
+// can only end with the association to that AP; the STA MAC offers no
+// way to set the association, so the scanning and the association
+// exchange still take place over the air.
+void
+AssociateToBestAp (Ptr<SpectrumChannel> channel, NetDeviceContainer apDevices, NetDeviceContainer staDevices)
+{
+  Ptr<CoexistenceSpectrumChannel> coexistenceChannel = DynamicCast<CoexistenceSpectrumChannel> (channel);
+  NS_ABORT_MSG_UNLESS (coexistenceChannel, "oracleWifiAssociation requires ns3::CoexistenceSpectrumChannel");
+  std::vector<Ssid> apSsids;
+  for (uint32_t a = 0; a < apDevices.GetN (); ++a)
+    {
+      Ptr<WifiMac> apMac = DynamicCast<WifiNetDevice> (apDevices.Get (a))->GetMac ();
+      std::ostringstream ssid;
+      ssid << apMac->GetSsid ().PeekString () << "-" << a;
+      apSsids.push_back (Ssid (ssid.str ()));
+    }
+  for (uint32_t s = 0; s < staDevices.GetN (); ++s)
+    {
+      Ptr<Node> sta = staDevices.Get (s)->GetNode ();
+      Ptr<WifiMac> staMac = DynamicCast<WifiNetDevice> (staDevices.Get (s))->GetMac ();
+      uint32_t bestAp = apDevices.GetN ();
+      double bestLossDb = 0;
+      for (uint32_t a = 0; a < apDevices.GetN (); ++a)
+        {
+          Ptr<WifiMac> apMac = DynamicCast<WifiNetDevice> (apDevices.Get (a))->GetMac ();
+          if (!apMac->GetSsid ().IsEqual (staMac->GetSsid ()))
+            {
+              continue;
+            }
+          double lossDb = coexistenceChannel->GetCouplingLossDb (apDevices.Get (a)->GetNode ()->GetObject<MobilityModel> (),
+                                                                 sta->GetObject<MobilityModel> ());
+          if (bestAp == apDevices.GetN () || lossDb < bestLossDb)
+            {
+              bestAp = a;
+              bestLossDb = lossDb;
+            }
+        }
+      NS_ABORT_MSG_IF (bestAp == apDevices.GetN (), "no AP with the SSID of STA " << staMac->GetAddress ());
+      NS_LOG_LOGIC ("STA " << staMac->GetAddress () << " assigned to AP " << bestAp
+                           << " with loss " << bestLossDb << " dB");
+      staMac->SetSsid (apSsids[bestAp]);
+      InstallRoutesForStation (sta, staDevices.Get (s), apDevices.Get (bestAp)->GetNode ());
+    }
+  for (uint32_t a = 0; a < apDevices.GetN (); ++a)
+    {
+      DynamicCast<WifiNetDevice> (apDevices.Get (a))->GetMac ()->SetSsid (apSsids[a]);
+    }
+}
+
 void
 PrintFlowMonitorStats (Ptr<FlowMonitor> monitor, FlowMonitorHelper& flowmonHelper, double duration)
 {
@@ -435,8 +619,185 @@ SaveUdpFlowMonitorStats (std::string filename, std::string simulationParams, Ptr
   outFile.close ();
 }
 
+// Compute the RSRP of an eNB at a UE from the coupling loss of the DL
+// channel, without fading
+static double
+CalcRsrpDbm (Ptr<CoexistenceSpectrumChannel> dlChannel, Ptr<LteEnbNetDevice> enbLteDevice, Ptr<LteUeNetDevice> ueLteDevice)
+{
+  Ptr<LteEnbPhy> enbPhy = enbLteDevice->GetPhy ();
+  // all the RBs are transmitted with the same power
+  return enbPhy->GetTxPower () - 10 * std::log10 (enbLteDevice->GetDlBandwidth ())
+    - dlChannel->GetCouplingLossDb (enbPhy->GetDownlinkSpectrumPhy (), ueLteDevice->GetPhy ()->GetDownlinkSpectrumPhy ());
+}
+
+// Attach each UE to the eNB with the highest RSRP among those it is
+// allowed to access, using the coupling losses of the DL channel,
+// without fading; the UE camps on the cell directly, without cell search
 void
-ConfigureLte (Ptr<LteHelper> lteHelper, Ptr<PointToPointEpcHelper> epcHelper, Ipv4AddressHelper& internetIpv4Helper, NodeContainer bsNodes, NodeContainer ueNodes, NodeContainer clientNodes, NetDeviceContainer& bsDevices, NetDeviceContainer& ueDevices, struct PhyParams phyParams, std::vector<LteSpectrumValueCatcher>& lteDlSinrCatcherVector, std::bitset<40> absPattern, Transport_e transport)
+AttachToBestCell (Ptr<LteHelper> lteHelper, NetDeviceContainer ueDevices, NetDeviceContainer enbDevices)
+{
+  Ptr<CoexistenceSpectrumChannel> dlChannel = DynamicCast<CoexistenceSpectrumChannel> (lteHelper->GetDownlinkSpectrumChannel ());
+  NS_ABORT_MSG_UNLESS (dlChannel, "directAttach requires ns3::CoexistenceSpectrumChannel");
+  for (uint32_t u = 0; u < ueDevices.GetN (); ++u)
+    {
+      Ptr<LteUeNetDevice> ueLteDevice = ueDevices.Get (u)->GetObject<LteUeNetDevice> ();
+      Ptr<NetDevice> bestEnbDevice;
+      double bestRsrpDbm = 0;
+      for (uint32_t n = 0; n < enbDevices.GetN (); ++n)
+        {
+          Ptr<LteEnbNetDevice> enbLteDevice = enbDevices.Get (n)->GetObject<LteEnbNetDevice> ();
+          if (enbLteDevice->GetCsgIndication () && enbLteDevice->GetCsgId () != ueLteDevice->GetCsgId ())
+            {
+              continue;
+            }
+          double rsrpDbm = CalcRsrpDbm (dlChannel, enbLteDevice, ueLteDevice);
+          if (bestEnbDevice == 0 || rsrpDbm > bestRsrpDbm)
+            {
+              bestEnbDevice = enbDevices.Get (n);
+              bestRsrpDbm = rsrpDbm;
+            }
+        }
+      NS_ABORT_MSG_UNLESS (bestEnbDevice, "no eNB accessible by UE " << ueLteDevice->GetImsi ());
+      NS_LOG_LOGIC ("UE " << ueLteDevice->GetImsi () << " attached to cell "
+                          << bestEnbDevice->GetObject<LteEnbNetDevice> ()->GetCellId ()
+                          << " with RSRP " << bestRsrpDbm << " dBm");
+      lteHelper->Attach (ueDevices.Get (u), bestEnbDevice);
+    }
+}
+
+// Restrict the measurements of each UE to the nCells eNBs with the
+// highest RSRP among those it is allowed to access, selected once with
+// the coupling losses of the DL channel, without fading
+void
+SelectMeasuredCells (Ptr<LteHelper> lteHelper, NetDeviceContainer ueDevices, NetDeviceContainer enbDevices, uint32_t nCells)
+{
+  Ptr<CoexistenceSpectrumChannel> dlChannel = DynamicCast<CoexistenceSpectrumChannel> (lteHelper->GetDownlinkSpectrumChannel ());
+  NS_ABORT_MSG_UNLESS (dlChannel, "measurementCells requires ns3::CoexistenceSpectrumChannel");
+  for (uint32_t u = 0; u < ueDevices.GetN (); ++u)
+    {
+      Ptr<LteUeNetDevice> ueLteDevice = ueDevices.Get (u)->GetObject<LteUeNetDevice> ();
+      // ties are broken by cell ID, so that the selection is reproducible
+      std::vector<std::pair<double, uint16_t> > cells;
+      for (uint32_t n = 0; n < enbDevices.GetN (); ++n)
+        {
+          Ptr<LteEnbNetDevice> enbLteDevice = enbDevices.Get (n)->GetObject<LteEnbNetDevice> ();
+          if (enbLteDevice->GetCsgIndication () && enbLteDevice->GetCsgId () != ueLteDevice->GetCsgId ())
+            {
+              continue;
+            }
+          cells.push_back (std::make_pair (-CalcRsrpDbm (dlChannel, enbLteDevice, ueLteDevice), enbLteDevice->GetCellId ()));
+        }
+      std::sort (cells.begin (), cells.end ());
+      std::set<uint16_t> cellIds;
+      for (uint32_t i = 0; i < cells.size () && i < nCells; ++i)
+        {
+          cellIds.insert (cells[i].second);
+        }
+      NS_LOG_LOGIC ("UE " << ueLteDevice->GetImsi () << " measures " << cellIds.size () << " of " << cells.size () << " cells");
+      dlChannel->SetMeasuredCells (ueLteDevice->GetPhy ()->GetDownlinkSpectrumPhy (), cellIds);
+    }
+}
+
+// Install a full-buffer source on each AP, running while the clients would
+ApplicationContainer
+ConfigureFullBufferSources (NetDeviceContainer apDevices, Time startTime, Time stopTime)
+{
+  ApplicationContainer sources;
+  for (uint32_t i = 0; i < apDevices.GetN (); i++)
+    {
+      Ptr<FullBufferWifiSource> source = CreateObject<FullBufferWifiSource> ();
+      source->SetDevice (DynamicCast<WifiNetDevice> (apDevices.Get (i)));
+      apDevices.Get (i)->GetNode ()->AddApplication (source);
+      sources.Add (source);
+    }
+  sources.Start (startTime);
+  sources.Stop (stopTime);
+  return sources;
+}
+
+// Add a STA to the destinations of the full-buffer source of the AP it
+// associates with, or remove it when it leaves the AP
+void
+UpdateFullBufferDestinations (ApplicationContainer sources, bool associated, std::string context, Mac48Address apAddress)
+{
+  Ptr<Node> node = NodeList::GetNode (ContextToNodeId (context));
+  Ptr<WifiNetDevice> sta = DynamicCast<WifiNetDevice> (node->GetDevice (ContextToDeviceId (context)));
+  for (ApplicationContainer::Iterator it = sources.Begin (); it != sources.End (); ++it)
+    {
+      Ptr<FullBufferWifiSource> source = DynamicCast<FullBufferWifiSource> (*it);
+      if (source->GetDevice ()->GetMac ()->GetAddress () == apAddress)
+        {
+          if (associated)
+            {
+              source->AddDestination (sta);
+            }
+          else
+            {
+              source->RemoveDestination (sta);
+            }
+        }
+    }
+}
+
+// Bytes received by each STA from the full-buffer sources of the APs
+std::vector<uint64_t>
+GetFullBufferRxBytes (ApplicationContainer sources, NetDeviceContainer staDevices)
+{
+  std::vector<uint64_t> rxBytes (staDevices.GetN (), 0);
+  for (uint32_t i = 0; i < staDevices.GetN (); i++)
+    {
+      Mac48Address address = Mac48Address::ConvertFrom (staDevices.Get (i)->GetAddress ());
+      for (ApplicationContainer::Iterator it = sources.Begin (); it != sources.End (); ++it)
+        {
+          rxBytes[i] += DynamicCast<FullBufferWifiSource> (*it)->GetRxBytes (address);
+        }
+    }
+  return rxBytes;
+}
+
+// Save the bytes received by each UE on its first data radio bearer
+// (LCID 3) since the StartTime of the RLC statistics
+void
+SaveLteRxBytes (Ptr<RadioBearerStatsCalculator> rlcStats, NetDeviceContainer ueDevices, std::vector<uint64_t> *rxBytes)
+{
+  rxBytes->clear ();
+  for (uint32_t i = 0; i < ueDevices.GetN (); i++)
+    {
+      uint64_t imsi = ueDevices.Get (i)->GetObject<LteUeNetDevice> ()->GetImsi ();
+      rxBytes->push_back (rlcStats->GetDlRxData (imsi, 3));
+    }
+}
+
+void
+PrintFullBufferStats (NodeContainer ueNodes, const std::vector<uint64_t> &rxBytes, double duration)
+{
+  for (uint32_t i = 0; i < rxBytes.size (); i++)
+    {
+      std::cout << "UE " << ueNodes.Get (i)->GetId () << "\n";
+      std::cout << "  Rx Bytes:   " << rxBytes[i] << "\n";
+      std::cout << "  Throughput: " << rxBytes[i] * 8.0 / duration / 1000 / 1000 << " Mbps\n";
+    }
+}
+
+void
+SaveFullBufferStats (std::string filename, NodeContainer ueNodes, const std::vector<uint64_t> &rxBytes, double duration)
+{
+  std::ofstream outFile;
+  outFile.open (filename.c_str (), std::ofstream::out | std::ofstream::app);
+  if (!outFile.is_open ())
+    {
+      NS_LOG_ERROR ("Can't open file " << filename);
+      return;
+    }
+  for (uint32_t i = 0; i < rxBytes.size (); i++)
+    {
+      outFile << ueNodes.Get (i)->GetId () << " " << rxBytes[i] << " " << rxBytes[i] * 8.0 / duration / 1000 / 1000 << std::endl;
+    }
+  outFile.close ();
+}
+
+void
+ConfigureLte (Ptr<LteHelper> lteHelper, Ptr<PointToPointEpcHelper> epcHelper, Ipv4AddressHelper& internetIpv4Helper, NodeContainer bsNodes, NodeContainer ueNodes, NodeContainer clientNodes, NetDeviceContainer& bsDevices, NetDeviceContainer& ueDevices, struct PhyParams phyParams, std::vector<LteSpectrumValueCatcher>& lteDlSinrCatcherVector, std::bitset<40> absPattern, Transport_e transport, Ptr<LteMiCache> lteCqiCacheEstimate)
 {
 
 
@@ -462,7 +823,9 @@ ConfigureLte (Ptr<LteHelper> lteHelper, Ptr<PointToPointEpcHelper> epcHelper, Ip
 
   
   // LTE configuration parametes
-  lteHelper->SetSchedulerType ("ns3::PfFfMacScheduler");
+  StringValue lteSchedulerType;
+  GlobalValue::GetValueByName ("lteSchedulerType", lteSchedulerType);
+  lteHelper->SetSchedulerType (lteSchedulerType.Get ());
   lteHelper->SetSchedulerAttribute ("UlCqiFilter", EnumValue (FfMacScheduler::PUSCH_UL_CQI));
  // LTE-U DL transmission @5180 MHz
   lteHelper->SetEnbDeviceAttribute ("DlEarfcn", UintegerValue (255444));
@@ -475,16 +838,27 @@ ConfigureLte (Ptr<LteHelper> lteHelper, Ptr<PointToPointEpcHelper> epcHelper, Ip
   Config::SetDefault ("ns3::LteEnbPhy::TxPower", DoubleValue (phyParams.m_bsTxPower));
   Config::SetDefault ("ns3::LteUePhy::TxPower", DoubleValue (phyParams.m_ueTxPower));
 
-  switch (transport)
+  BooleanValue fullBuffer;
+  GlobalValue::GetValueByName ("fullBuffer", fullBuffer);
+  if (fullBuffer.Get ())
     {
-    case TCP:
-      Config::SetDefault ("ns3::LteEnbRrc::EpsBearerToRlcMapping", EnumValue (LteEnbRrc::RLC_AM_ALWAYS));
-      break;
-      
-    case UDP:
-    default:
-      Config::SetDefault ("ns3::LteEnbRrc::EpsBearerToRlcMapping", EnumValue (LteEnbRrc::RLC_UM_ALWAYS));
-      break;
+      // RLC SM always reports a full buffer to the scheduler, and
+      // delivers nothing above the RLC
+      Config::SetDefault ("ns3::LteEnbRrc::EpsBearerToRlcMapping", EnumValue (LteEnbRrc::RLC_SM_ALWAYS));
+    }
+  else
+    {
+      switch (transport)
+        {
+        case TCP:
+          Config::SetDefault ("ns3::LteEnbRrc::EpsBearerToRlcMapping", EnumValue (LteEnbRrc::RLC_AM_ALWAYS));
+          break;
+
+        case UDP:
+        default:
+          Config::SetDefault ("ns3::LteEnbRrc::EpsBearerToRlcMapping", EnumValue (LteEnbRrc::RLC_UM_ALWAYS));
+          break;
+        }
     }
 
   // Create Devices and install them in the Nodes (eNBs and UEs)
@@ -514,6 +888,11 @@ ConfigureLte (Ptr<LteHelper> lteHelper, Ptr<PointToPointEpcHelper> epcHelper, Ip
       Ptr<Node> ue = ueNodes.Get (u);
       Ptr<NetDevice> ueDevice = ueLteDevs.Get (u);
       Ptr<LteUeNetDevice> ueLteDevice = ueDevice->GetObject<LteUeNetDevice> ();
+      if (fullBuffer.Get ())
+        {
+          // the LteHelper disables RLC SM at the UEs when the EPC is used
+          ueLteDevice->GetRrc ()->SetUseRlcSm (true);
+        }
 
       // assign IP address to UEs
       Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address (NetDeviceContainer (ueDevice));
@@ -527,11 +906,31 @@ ConfigureLte (Ptr<LteHelper> lteHelper, Ptr<PointToPointEpcHelper> epcHelper, Ip
       Ptr<LtePhy> uePhy = ueLteDevice->GetPhy ()->GetObject<LtePhy> ();
       Ptr<LteAverageChunkProcessor> monitorLteChunkProcessor  = Create<LteAverageChunkProcessor> ();
       monitorLteChunkProcessor->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &lteDlSinrCatcherVector.at(u)));
+      if (lteCqiCacheEstimate != 0)
+        {
+          monitorLteChunkProcessor->AddCallback (MakeCallback (&LteMiCache::CountCqiLookup, lteCqiCacheEstimate));
+        }
       uePhy->GetDownlinkSpectrumPhy ()->AddDataSinrChunkProcessor (monitorLteChunkProcessor);      
    }
 
-  // instruct all devices to attach using the LTE initial cell selection procedure
-  lteHelper->Attach (ueDevices);
+  UintegerValue measurementCells;
+  GlobalValue::GetValueByName ("measurementCells", measurementCells);
+  if (measurementCells.Get () > 0)
+    {
+      SelectMeasuredCells (lteHelper, ueDevices, bsDevices, measurementCells.Get ());
+    }
+
+  BooleanValue directAttach;
+  GlobalValue::GetValueByName ("directAttach", directAttach);
+  if (directAttach.Get ())
+    {
+      AttachToBestCell (lteHelper, ueDevices, bsDevices);
+    }
+  else
+    {
+      // instruct all devices to attach using the LTE initial cell selection procedure
+      lteHelper->Attach (ueDevices);
+    }
 }
 
 NetDeviceContainer 
@@ -559,8 +958,17 @@ ConfigureWifiAp (NodeContainer bsNodes, struct PhyParams phyParams, Ptr<Spectrum
   spectrumPhy.Set ("RxNoiseFigure", DoubleValue (phyParams.m_bsNoiseFigure));
   spectrumPhy.Set ("Receivers", UintegerValue (2));
   spectrumPhy.Set ("Transmitters", UintegerValue (2));
+  StringValue errorRateTableFile;
+  GlobalValue::GetValueByName ("errorRateTableFile", errorRateTableFile);
+  if (!errorRateTableFile.Get ().empty ())
+    {
+      spectrumPhy.SetErrorRateModel ("ns3::TableErrorRateModel",
+                                     "TableFile", errorRateTableFile);
+    }
 
-  wifi.SetRemoteStationManager ("ns3::IdealWifiManager");
+  StringValue wifiRemoteStationManager;
+  GlobalValue::GetValueByName ("wifiRemoteStationManager", wifiRemoteStationManager);
+  wifi.SetRemoteStationManager (wifiRemoteStationManager.Get ());
 
   mac.SetType ("ns3::ApWifiMac",
                "Ssid", SsidValue (ssid),
@@ -602,8 +1010,17 @@ ConfigureWifiSta (NodeContainer ueNodes, struct PhyParams phyParams, Ptr<Spectru
   spectrumPhy.Set ("RxNoiseFigure", DoubleValue (phyParams.m_ueNoiseFigure));
   spectrumPhy.Set ("Receivers", UintegerValue (2));
   spectrumPhy.Set ("Transmitters", UintegerValue (2));
+  StringValue errorRateTableFile;
+  GlobalValue::GetValueByName ("errorRateTableFile", errorRateTableFile);
+  if (!errorRateTableFile.Get ().empty ())
+    {
+      spectrumPhy.SetErrorRateModel ("ns3::TableErrorRateModel",
+                                     "TableFile", errorRateTableFile);
+    }
 
-  wifi.SetRemoteStationManager ("ns3::IdealWifiManager");
+  StringValue wifiRemoteStationManager;
+  GlobalValue::GetValueByName ("wifiRemoteStationManager", wifiRemoteStationManager);
+  wifi.SetRemoteStationManager (wifiRemoteStationManager.Get ());
 
   mac.SetType ("ns3::StaWifiMac",
                "Ssid", SsidValue (ssid),
@@ -652,12 +1069,42 @@ ConfigureUdpClients (NodeContainer client, Ipv4InterfaceContainer servers, Time
   clientHelper.SetAttribute ("PacketSize", UintegerValue (packetSize));
   clientHelper.SetAttribute ("RemotePort", UintegerValue (remotePort));
 
+  // a single application and timer per client node, sending to all
+  // the UEs in the same order as the UdpClients
+  BooleanValue aggregatedUdpClient;
+  GlobalValue::GetValueByName ("aggregatedUdpClient", aggregatedUdpClient);
+  std::vector<Ptr<MultiDestinationUdpClient> > aggregatedApps;
+  if (aggregatedUdpClient.Get ())
+    {
+      for (uint32_t j = 0; j < client.GetN (); j++)
+        {
+          Ptr<MultiDestinationUdpClient> app = CreateObject<MultiDestinationUdpClient> ();
+          app->SetAttribute ("MaxPackets", UintegerValue (1e6));
+          app->SetAttribute ("Interval", TimeValue (interval));
+          app->SetAttribute ("PacketSize", UintegerValue (packetSize));
+          app->SetAttribute ("RemotePort", UintegerValue (remotePort));
+          client.Get (j)->AddApplication (app);
+          clientApps.Add (app);
+          aggregatedApps.push_back (app);
+        }
+    }
+
   ApplicationContainer pingApps;
   for (uint32_t i = 0; i < servers.GetN (); i++)
     {
       Ipv4Address ip = servers.GetAddress (i, 0);
-      clientHelper.SetAttribute ("RemoteAddress", AddressValue (ip));
-      clientApps.Add (clientHelper.Install (client));
+      if (aggregatedUdpClient.Get ())
+        {
+          for (uint32_t j = 0; j < aggregatedApps.size (); j++)
+            {
+              aggregatedApps[j]->AddDestination (ip);
+            }
+        }
+      else
+        {
+          clientHelper.SetAttribute ("RemoteAddress", AddressValue (ip));
+          clientApps.Add (clientHelper.Install (client));
+        }
 
       // Seed the ARP cache by pinging early in the simulation
       // This is a workaround until a static ARP capability is provided
@@ -754,6 +1201,25 @@ StartFileTransfer (Ptr<ExponentialRandomVariable> ftpArrivals, ApplicationContai
 
 
 
+// Save the heap allocations made since the previous call, and
+// reschedule itself one simulated second later
+void
+SaveAllocationStats (std::string filename, uint64_t lastCount, uint64_t lastBytes)
+{
+  uint64_t count = GetHeapAllocationCount ();
+  uint64_t bytes = GetHeapAllocatedBytes ();
+  std::ofstream outFile;
+  outFile.open (filename.c_str (), std::ofstream::out | std::ofstream::app);
+  if (!outFile.is_open ())
+    {
+      NS_LOG_ERROR ("Can't open file " << filename);
+      return;
+    }
+  outFile << Simulator::Now ().GetSeconds () << " " << count - lastCount << " " << bytes - lastBytes << std::endl;
+  outFile.close ();
+  Simulator::Schedule (Seconds (1), &SaveAllocationStats, filename, count, bytes);
+}
+
 void 
 PrintGnuplottableNodeListToFile (std::string filename, NodeContainer nodes, bool printId, std::string label, std::string howToPlot)
 {
@@ -812,6 +1278,27 @@ ConfigureAndRunScenario (Config_e cellConfigA,
   GlobalValue::GetValueByName ("simulationLingerTimeSeconds", doubleValue);
   Time simulationLingerTime = Seconds (doubleValue.Get ());
 
+  BooleanValue countSchedulerOperations;
+  GlobalValue::GetValueByName ("countSchedulerOperations", countSchedulerOperations);
+  if (countSchedulerOperations.Get ())
+    {
+      // count the operations on the scheduler selected with --SchedulerType
+      TypeIdValue schedulerType;
+      GlobalValue::GetValueByName ("SchedulerType", schedulerType);
+      // with --SchedulerType=ns3::CountingScheduler, the simulator
+      // already counts them; wrapping it again would count every
+      // operation twice, since the counters are shared
+      if (schedulerType.Get () != CountingScheduler::GetTypeId ())
+        {
+          ObjectFactory schedulerFactory;
+          schedulerFactory.SetTypeId ("ns3::CountingScheduler");
+          schedulerFactory.Set ("SchedulerType", StringValue (schedulerType.Get ().GetName ()));
+          Simulator::SetScheduler (schedulerFactory);
+        }
+      // do not count the events scheduled so far
+      CountingScheduler::ResetCounters ();
+    }
+
   // Now set start and stop times derived from the above
   Time serverStopTime = serverStartTime + durationTime + serverLingerTime;
   Time clientStopTime = clientStartTime + durationTime;
@@ -889,12 +1376,51 @@ ConfigureAndRunScenario (Config_e cellConfigA,
   // licensed bands, hence we model it using the ideal RRC 
   lteHelper->SetAttribute ("UseIdealRrc", BooleanValue (true));
   lteHelper->SetAttribute ("UsePdschForCqiGeneration", BooleanValue (true));
+  // the channel type must be set before the LteHelper creates the channels
+  StringValue spectrumChannelType;
+  GlobalValue::GetValueByName ("spectrumChannelType", spectrumChannelType);
+  lteHelper->SetSpectrumChannelType (spectrumChannelType.Get ());
+
+  StringValue fadingTraceFile;
+  GlobalValue::GetValueByName ("fadingTraceFile", fadingTraceFile);
+  if (!fadingTraceFile.Get ().empty ())
+    {
+      // Wi-Fi devices share the LTE downlink channel, so they are also affected
+      lteHelper->SetFadingModel ("ns3::MmapTraceFadingLossModel");
+      lteHelper->SetFadingModelAttribute ("TraceFilename", fadingTraceFile);
+    }
+
+  BooleanValue reducedSignalling;
+  GlobalValue::GetValueByName ("reducedSignalling", reducedSignalling);
+  if (reducedSignalling.Get () && spectrumChannelType.Get () == "ns3::CoexistenceSpectrumChannel")
+    {
+      lteHelper->SetSpectrumChannelAttribute ("ReducedSignalling", BooleanValue (true));
+    }
+
+  BooleanValue cullBeacons;
+  GlobalValue::GetValueByName ("cullBeacons", cullBeacons);
+  if (cullBeacons.Get () && spectrumChannelType.Get () == "ns3::CoexistenceSpectrumChannel")
+    {
+      lteHelper->SetSpectrumChannelAttribute ("CullBeacons", BooleanValue (true));
+      // the associated STAs no longer see the beacons, and must not
+      // drop the association for missing them (10^6 beacons is 28 h)
+      Config::SetDefault ("ns3::StaWifiMac::MaxMissedBeacons", UintegerValue (1000000));
+    }
 
   Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
   lteHelper->SetEpcHelper (epcHelper);
   lteHelper->Initialize ();
   std::vector<LteSpectrumValueCatcher> lteDlSinrCatcherVectorA;
   std::vector<LteSpectrumValueCatcher> lteDlSinrCatcherVectorB;
+  BooleanValue lteCqiCacheStats;
+  GlobalValue::GetValueByName ("lteCqiCacheStats", lteCqiCacheStats);
+  DoubleValue lteMiCacheQuantization;
+  GlobalValue::GetValueByName ("lteMiCacheQuantization", lteMiCacheQuantization);
+  Ptr<LteMiCache> lteCqiCacheEstimate;
+  if (lteCqiCacheStats.Get ())
+    {
+      lteCqiCacheEstimate = Create<LteMiCache> (lteMiCacheQuantization.Get ());
+    }
 
   // set channel MaxLossDb to discard all transmissions below -15dB SNR. 
   // The calculations assume -174 dBm/Hz noise PSD and 20 MHz bandwidth (73 dB)
@@ -988,7 +1514,7 @@ ConfigureAndRunScenario (Config_e cellConfigA,
       lteHelper->SetUeDeviceAttribute ("CsgId", UintegerValue (1));
       Ipv4AddressHelper internetIpv4Helper;
       internetIpv4Helper.SetBase ("1.0.0.0", "255.0.0.0");
-      ConfigureLte (lteHelper, epcHelper, internetIpv4Helper, bsNodesA, ueNodesA, clientNodesA, bsDevicesA, ueDevicesA, phyParams, lteDlSinrCatcherVectorA, absPattern, transport);
+      ConfigureLte (lteHelper, epcHelper, internetIpv4Helper, bsNodesA, ueNodesA, clientNodesA, bsDevicesA, ueDevicesA, phyParams, lteDlSinrCatcherVectorA, absPattern, transport, lteCqiCacheEstimate);
     }
 
   //
@@ -1021,7 +1547,7 @@ ConfigureAndRunScenario (Config_e cellConfigA,
       lteHelper->SetUeDeviceAttribute ("CsgId", UintegerValue (2));
       Ipv4AddressHelper internetIpv4Helper;
       internetIpv4Helper.SetBase ("2.0.0.0", "255.0.0.0");
-      ConfigureLte (lteHelper, epcHelper,  internetIpv4Helper, bsNodesB, ueNodesB, clientNodesB, bsDevicesB, ueDevicesB, phyParams, lteDlSinrCatcherVectorB, absPattern, transport);
+      ConfigureLte (lteHelper, epcHelper,  internetIpv4Helper, bsNodesB, ueNodesB, clientNodesB, bsDevicesB, ueDevicesB, phyParams, lteDlSinrCatcherVectorB, absPattern, transport, lteCqiCacheEstimate);
     }
 
   //
@@ -1043,9 +1569,33 @@ ConfigureAndRunScenario (Config_e cellConfigA,
   ipUeB = ueAddress.Assign (ueDevicesB);
 
   // Routing
-  // WiFi nodes will trigger an association callback, which can invoke
-  // a method to configure the appropriate routes on client and STA
-  Config::Connect("/NodeList/*/DeviceList/*/Mac/Assoc", MakeCallback(&ConfigureRouteForStation));
+  BooleanValue oracleWifiAssociation;
+  GlobalValue::GetValueByName ("oracleWifiAssociation", oracleWifiAssociation);
+  if (oracleWifiAssociation.Get ())
+    {
+      // the routes are installed now, and do not change since each
+      // STA can only associate with one AP
+      if (cellConfigA == WIFI)
+        {
+          AssociateToBestAp (lteHelper->GetDownlinkSpectrumChannel (), bsDevicesA, ueDevicesA);
+        }
+      if (cellConfigB == WIFI)
+        {
+          AssociateToBestAp (lteHelper->GetDownlinkSpectrumChannel (), bsDevicesB, ueDevicesB);
+        }
+    }
+  else
+    {
+      // WiFi nodes will trigger an association callback, which can invoke
+      // a method to configure the appropriate routes on client and STA
+      Config::Connect("/NodeList/*/DeviceList/*/Mac/Assoc", MakeCallback(&ConfigureRouteForStation));
+    }
+  Ptr<CoexistenceSpectrumChannel> wifiChannel = DynamicCast<CoexistenceSpectrumChannel> (lteHelper->GetDownlinkSpectrumChannel ());
+  if (cullBeacons.Get () && wifiChannel)
+    {
+      Config::Connect ("/NodeList/*/DeviceList/*/Mac/Assoc", MakeBoundCallback (&CullBeaconsOfStation, wifiChannel, true));
+      Config::Connect ("/NodeList/*/DeviceList/*/Mac/DeAssoc", MakeBoundCallback (&CullBeaconsOfStation, wifiChannel, false));
+    }
 
   //
   // Application setup phase
@@ -1062,7 +1612,49 @@ ConfigureAndRunScenario (Config_e cellConfigA,
   uint32_t nextClient = 0;
 
   ApplicationContainer serverApps, clientApps;
-  if (disableApps == false)
+  BooleanValue fullBuffer;
+  GlobalValue::GetValueByName ("fullBuffer", fullBuffer);
+  ApplicationContainer fullBufferSources;
+  std::vector<uint64_t> fullBufferRxBytesA;
+  std::vector<uint64_t> fullBufferRxBytesB;
+  if (fullBuffer.Get ())
+    {
+      // the eNBs use RLC SM, configured in ConfigureLte; the APs send to
+      // the STAs associated with them
+      if (cellConfigA == WIFI)
+        {
+          fullBufferSources.Add (ConfigureFullBufferSources (bsDevicesA, clientStartTime, clientStopTime));
+        }
+      if (cellConfigB == WIFI)
+        {
+          fullBufferSources.Add (ConfigureFullBufferSources (bsDevicesB, clientStartTime, clientStopTime));
+        }
+      if (fullBufferSources.GetN () > 0)
+        {
+          Config::Connect ("/NodeList/*/DeviceList/*/Mac/Assoc", MakeBoundCallback (&UpdateFullBufferDestinations, fullBufferSources, true));
+          Config::Connect ("/NodeList/*/DeviceList/*/Mac/DeAssoc", MakeBoundCallback (&UpdateFullBufferDestinations, fullBufferSources, false));
+        }
+      if (cellConfigA == LTE || cellConfigB == LTE)
+        {
+          // the RLC statistics count from the start of the clients, in a
+          // single epoch, and are saved when the clients would stop
+          lteHelper->EnableRlcTraces ();
+          Ptr<RadioBearerStatsCalculator> rlcStats = lteHelper->GetRlcStats ();
+          rlcStats->SetAttribute ("StartTime", TimeValue (clientStartTime));
+          rlcStats->SetAttribute ("EpochDuration", TimeValue (stopTime));
+          rlcStats->SetAttribute ("DlRlcOutputFilename", StringValue (outFileName + "_DlRlcStats.txt"));
+          rlcStats->SetAttribute ("UlRlcOutputFilename", StringValue (outFileName + "_UlRlcStats.txt"));
+          if (cellConfigA == LTE)
+            {
+              Simulator::Schedule (clientStopTime, &SaveLteRxBytes, rlcStats, ueDevicesA, &fullBufferRxBytesA);
+            }
+          if (cellConfigB == LTE)
+            {
+              Simulator::Schedule (clientStopTime, &SaveLteRxBytes, rlcStats, ueDevicesB, &fullBufferRxBytesB);
+            }
+        }
+    }
+  else if (disableApps == false)
     {
       if (transport == UDP)
         {
@@ -1161,34 +1753,123 @@ ConfigureAndRunScenario (Config_e cellConfigA,
       Simulator::Stop (stopTime);
     }
 
+  BooleanValue allocationStats;
+  GlobalValue::GetValueByName ("allocationStats", allocationStats);
+  NS_ABORT_MSG_IF (allocationStats.Get () && !IsHeapAllocationCounted (),
+                   "allocationStats needs the module configured with --enable-laa-allocation-stats");
+  if (allocationStats.Get ())
+    {
+      std::string allocationsFileName = outFileName + "_allocations";
+      std::ofstream allocationsFile (allocationsFileName.c_str (), std::ios_base::out | std::ios_base::trunc);
+      allocationsFile << "# time(s) allocations bytes" << std::endl;
+      allocationsFile.close ();
+      Simulator::Schedule (Seconds (1), &SaveAllocationStats, allocationsFileName, GetHeapAllocationCount (), GetHeapAllocatedBytes ());
+    }
+  uint64_t allocationsBeforeRun = GetHeapAllocationCount ();
+  SystemWallClockMs wallClock;
+
   //
   // Running the simulation
   //
 
+  wallClock.Start ();
   Simulator::Run ();
+  double runTime = wallClock.End () / 1000.0;
 
-  //
-  // Post-processing phase
-  //
+  std::cout << "Run time: " << runTime << " s, LTE duty cycle " << actualLteDutyCycle << std::endl;
 
-  std::cout << "--------monitorA----------" << std::endl;
-  PrintFlowMonitorStats (monitorA, flowmonHelperA, durationTime.GetSeconds ());
-  std::cout << "--------monitorB----------" << std::endl;
-  PrintFlowMonitorStats (monitorB, flowmonHelperB, durationTime.GetSeconds ());
+  if (countSchedulerOperations.Get ())
+    {
+      // the simulation speed depends mostly on the number of events, which
+      // depends on the LTE duty cycle, since blank subframes are not transmitted
+      uint64_t events = CountingScheduler::GetNRemoveNexts ();
+      std::cout << "Events executed: " << events << " ("
+                << (runTime > 0 ? events / runTime : 0) << " per second, "
+                << events / Simulator::Now ().GetSeconds () << " per simulated second)" << std::endl;
+      std::cout << "Event queue: " << CountingScheduler::GetNInserts () << " insertions, "
+                << CountingScheduler::GetNRemoveNexts () << " removals for execution, "
+                << CountingScheduler::GetNRemoves () << " removals of cancelled events, "
+                << CountingScheduler::GetNSameTimeEvents () << " events at the time of the previous one, "
+                << "maximum size " << CountingScheduler::GetMaxSize () << std::endl;
+    }
+
+  if (allocationStats.Get ())
+    {
+      std::cout << "Heap allocations during the run: " << GetHeapAllocationCount () - allocationsBeforeRun
+                << " (" << (GetHeapAllocationCount () - allocationsBeforeRun) / Simulator::Now ().GetSeconds ()
+                << " per simulated second)" << std::endl;
+    }
 
-  if (transport == TCP)
+  Ptr<CoexistenceSpectrumChannel> coexistenceChannel = DynamicCast<CoexistenceSpectrumChannel> (lteHelper->GetDownlinkSpectrumChannel ());
+  if (coexistenceChannel)
     {
-      SaveTcpFlowMonitorStats (outFileName + "_operatorA", simulationParams, monitorA, flowmonHelperA, durationTime.GetSeconds ());
-      SaveTcpFlowMonitorStats (outFileName + "_operatorB", simulationParams, monitorB, flowmonHelperB, durationTime.GetSeconds ());  
+      std::cout << "DL channel: " << coexistenceChannel->GetNTransmissions () << " transmissions, "
+                << coexistenceChannel->GetNDeliveries () << " deliveries, "
+                << coexistenceChannel->GetNSuppressedDeliveries () << " suppressed deliveries, "
+                << coexistenceChannel->GetNPrunedMeasurements () << " pruned measurements" << std::endl;
+      if (cullBeacons.Get ())
+        {
+          std::cout << "Wi-Fi beacons: " << coexistenceChannel->GetNBeaconDeliveries () << " deliveries, "
+                    << coexistenceChannel->GetNCulledBeacons () << " skipped" << std::endl;
+        }
     }
-  else if (transport == UDP)
+  // in the UL, the transmissions of idle UEs are their periodic SRS
+  coexistenceChannel = DynamicCast<CoexistenceSpectrumChannel> (lteHelper->GetUplinkSpectrumChannel ());
+  if (coexistenceChannel)
     {
-      SaveUdpFlowMonitorStats (outFileName + "_operatorA", simulationParams, monitorA, flowmonHelperA, durationTime.GetSeconds ());
-      SaveUdpFlowMonitorStats (outFileName + "_operatorB", simulationParams, monitorB, flowmonHelperB, durationTime.GetSeconds ());  
+      std::cout << "UL channel: " << coexistenceChannel->GetNTransmissions () << " transmissions, "
+                << coexistenceChannel->GetNDeliveries () << " deliveries" << std::endl;
+    }
+
+  if (lteCqiCacheStats.Get ())
+    {
+      std::cout << "LTE DL CQI cache estimate: " << lteCqiCacheEstimate->GetHits () + lteCqiCacheEstimate->GetMisses ()
+                << " SINR reports, hit rate " << lteCqiCacheEstimate->GetHitRate ()
+                << " with a " << lteMiCacheQuantization.Get () << " dB step" << std::endl;
+    }
+
+  //
+  // Post-processing phase
+  //
+
+  if (fullBuffer.Get ())
+    {
+      if (cellConfigA == WIFI)
+        {
+          fullBufferRxBytesA = GetFullBufferRxBytes (fullBufferSources, ueDevicesA);
+        }
+      if (cellConfigB == WIFI)
+        {
+          fullBufferRxBytesB = GetFullBufferRxBytes (fullBufferSources, ueDevicesB);
+        }
+      std::cout << "--------full buffer A----------" << std::endl;
+      PrintFullBufferStats (ueNodesA, fullBufferRxBytesA, durationTime.GetSeconds ());
+      std::cout << "--------full buffer B----------" << std::endl;
+      PrintFullBufferStats (ueNodesB, fullBufferRxBytesB, durationTime.GetSeconds ());
+      SaveFullBufferStats (outFileName + "_operatorA_full_buffer", ueNodesA, fullBufferRxBytesA, durationTime.GetSeconds ());
+      SaveFullBufferStats (outFileName + "_operatorB_full_buffer", ueNodesB, fullBufferRxBytesB, durationTime.GetSeconds ());
     }
   else
     {
-      NS_FATAL_ERROR ("transport parameter invalid: " << transport);
+      std::cout << "--------monitorA----------" << std::endl;
+      PrintFlowMonitorStats (monitorA, flowmonHelperA, durationTime.GetSeconds ());
+      std::cout << "--------monitorB----------" << std::endl;
+      PrintFlowMonitorStats (monitorB, flowmonHelperB, durationTime.GetSeconds ());
+
+      if (transport == TCP)
+        {
+          SaveTcpFlowMonitorStats (outFileName + "_operatorA", simulationParams, monitorA, flowmonHelperA, durationTime.GetSeconds ());
+          SaveTcpFlowMonitorStats (outFileName + "_operatorB", simulationParams, monitorB, flowmonHelperB, durationTime.GetSeconds ());
+        }
+      else if (transport == UDP)
+        {
+          SaveUdpFlowMonitorStats (outFileName + "_operatorA", simulationParams, monitorA, flowmonHelperA, durationTime.GetSeconds ());
+          SaveUdpFlowMonitorStats (outFileName + "_operatorB", simulationParams, monitorB, flowmonHelperB, durationTime.GetSeconds ());
+        }
+      else
+        {
+          NS_FATAL_ERROR ("transport parameter invalid: " << transport);
+        }
     }
 
   Simulator::Destroy ();
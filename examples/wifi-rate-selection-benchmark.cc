@@ -0,0 +1,136 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+// Compare the cost of the data mode selection of IdealWifiManager and
+// ThresholdIdealWifiManager.
+//
+// An 802.11n PHY sends data frames to nStations stations in turn; before
+// each frame, the SNR of the station changes by up to snrStepDb, in a
+// random walk between -5 and 40 dB, and is reported to the manager as
+// the SNR of the last frame acknowledged.  The program prints the
+// decisions per second of each manager, and checks that they select the
+// same modes.  For example:
+//
+//   for s in 0.1 1 10; do ./waf --run "wifi-rate-selection-benchmark --snrStepDb=$s"; done
+
+#include <ns3/core-module.h>
+#include <ns3/network-module.h>
+#include <ns3/wifi-module.h>
+#include <ns3/threshold-ideal-wifi-manager.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+// Run the benchmark on a manager, and return the modes selected
+template <class Manager>
+std::vector<WifiMode>
+RunBenchmark (Ptr<Manager> manager, Ptr<WifiPhy> phy, uint32_t nStations, uint32_t nDecisions,
+              double snrStepDb, int64_t &elapsedMs)
+{
+  manager->SetupPhy (phy);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<WifiMacHeader> headers;
+  for (uint32_t i = 0; i < nStations; ++i)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      for (uint32_t m = 0; m < phy->GetNModes (); ++m)
+        {
+          manager->AddSupportedMode (address, phy->GetMode (m));
+        }
+      WifiMacHeader hdr;
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetAddr1 (address);
+      hdr.SetQosTid (0);
+      headers.push_back (hdr);
+    }
+  // the SNRs are drawn in advance, so that only the managers are timed
+  std::vector<double> snrs;
+  std::vector<double> snrDb (nStations, 15.0);
+  for (uint32_t k = 0; k < nDecisions; ++k)
+    {
+      uint32_t i = k % nStations;
+      snrDb[i] = std::max (-5.0, std::min (40.0, snrDb[i] + random->GetValue (-snrStepDb, snrStepDb)));
+      snrs.push_back (std::pow (10.0, snrDb[i] / 10.0));
+    }
+  Ptr<Packet> packet = Create<Packet> (1500);
+  WifiMode ackMode = phy->GetMode (0);
+  std::vector<WifiMode> modes;
+  modes.reserve (nDecisions);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t k = 0; k < nDecisions; ++k)
+    {
+      const WifiMacHeader &hdr = headers[k % nStations];
+      manager->ReportDataOk (hdr.GetAddr1 (), &hdr, snrs[k], ackMode, snrs[k]);
+      modes.push_back (manager->GetDataTxVector (hdr.GetAddr1 (), &hdr, packet, packet->GetSize ()).GetMode ());
+    }
+  elapsedMs = clock.End ();
+  return modes;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nStations = 20;
+  uint32_t nDecisions = 1000000;
+  double snrStepDb = 1;
+
+  CommandLine cmd;
+  cmd.AddValue ("nStations", "number of stations", nStations);
+  cmd.AddValue ("nDecisions", "number of data modes selected", nDecisions);
+  cmd.AddValue ("snrStepDb", "maximum change of the SNR of a station between two frames", snrStepDb);
+  cmd.Parse (argc, argv);
+
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+
+  Ptr<IdealWifiManager> ideal = CreateObject<IdealWifiManager> ();
+  int64_t elapsedMs;
+  std::vector<WifiMode> expected = RunBenchmark (ideal, phy, nStations, nDecisions, snrStepDb, elapsedMs);
+  std::cout << "IdealWifiManager: " << nDecisions << " decisions in " << elapsedMs << " ms ("
+            << (elapsedMs > 0 ? 1000.0 * nDecisions / elapsedMs : 0) << " per second)" << std::endl;
+
+  Ptr<ThresholdIdealWifiManager> threshold = CreateObject<ThresholdIdealWifiManager> ();
+  std::vector<WifiMode> modes = RunBenchmark (threshold, phy, nStations, nDecisions, snrStepDb, elapsedMs);
+  std::cout << "ThresholdIdealWifiManager: " << nDecisions << " decisions in " << elapsedMs << " ms ("
+            << (elapsedMs > 0 ? 1000.0 * nDecisions / elapsedMs : 0) << " per second), "
+            << threshold->GetNSearches () << " searches" << std::endl;
+
+  uint32_t nDifferent = 0;
+  for (uint32_t k = 0; k < nDecisions; ++k)
+    {
+      if (!(modes[k] == expected[k]))
+        {
+          ++nDifferent;
+        }
+    }
+  if (nDifferent > 0)
+    {
+      std::cout << "WARNING: " << nDifferent << " different modes selected" << std::endl;
+      return 1;
+    }
+  return 0;
+}
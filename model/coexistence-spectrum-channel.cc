@@ -0,0 +1,740 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/node.h>
+#include <ns3/net-device.h>
+#include <ns3/mobility-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
+#include <ns3/lte-control-messages.h>
+#include <ns3/wifi-spectrum-signal-parameters.h>
+#include <ns3/packet.h>
+#include <algorithm>
+#include <cmath>
+
+#include "coexistence-spectrum-channel.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CoexistenceSpectrumChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (CoexistenceSpectrumChannel);
+
+/**
+ * Number of leading bytes of a serialized Wi-Fi MAC header read by
+ * IsWifiBeacon (): frame control, duration and receiver address
+ */
+static const uint32_t BEACON_PREFIX_SIZE = 10;
+
+/**
+ * \return the NetDevice a SpectrumPhy is attached to, or 0 if none
+ * (e.g., the SpectrumPhy used by the RadioEnvironmentMapHelper)
+ *
+ * \param phy the SpectrumPhy
+ */
+static Ptr<NetDevice>
+GetNetDeviceOf (Ptr<SpectrumPhy> phy)
+{
+  Ptr<Object> device = phy->GetDevice ();
+  if (device == 0)
+    {
+      return 0;
+    }
+  return device->GetObject<NetDevice> ();
+}
+
+
+CoexistenceSpectrumChannel::CoexistenceSpectrumChannel ()
+  : m_numDevices (0),
+    m_nTransmissions (0),
+    m_nDeliveries (0),
+    m_nSuppressedDeliveries (0),
+    m_ctrlFoldTolerance (MicroSeconds (1)),
+    m_nPrunedMeasurements (0),
+    m_cullBeacons (false),
+    m_nBeaconDeliveries (0),
+    m_nCulledBeacons (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CoexistenceSpectrumChannel::~CoexistenceSpectrumChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+CoexistenceSpectrumChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CoexistenceSpectrumChannel")
+    .SetParent<SpectrumChannel> ()
+    .SetGroupName ("LaaWifiCoexistence")
+    .AddConstructor<CoexistenceSpectrumChannel> ()
+    .AddAttribute ("MaxLossDb",
+                   "If a single-frequency PropagationLossModel is used, "
+                   "this value represents the maximum loss in dB for which "
+                   "transmissions will be passed to the receiving PHY. "
+                   "Signals for which the PropagationLossModel returns "
+                   "a loss bigger than this value will not be propagated "
+                   "to the receiver. The default value corresponds to "
+                   "considering all signals for reception.",
+                   DoubleValue (1.0e9),
+                   MakeDoubleAccessor (&CoexistenceSpectrumChannel::m_maxLossDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("ReducedSignalling",
+                   "If true, LTE DL control frames are only delivered to LTE "
+                   "receivers; for the other receivers (e.g., Wi-Fi), the energy "
+                   "of the control region is folded into the LTE data frame that "
+                   "immediately follows it.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&CoexistenceSpectrumChannel::m_reducedSignalling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CtrlFoldTolerance",
+                   "In the reduced-signalling mode, maximum gap between the end "
+                   "of a DL control frame and the start of the data frame of the "
+                   "same subframe for the control frame to be folded into it "
+                   "(the LTE PHY starts the data frame 1 ns after the end of the "
+                   "control region).",
+                   TimeValue (MicroSeconds (1)),
+                   MakeTimeAccessor (&CoexistenceSpectrumChannel::m_ctrlFoldTolerance),
+                   MakeTimeChecker ())
+    .AddAttribute ("CullBeacons",
+                   "If true, Wi-Fi beacons are not delivered to the devices "
+                   "registered with SetBeaconCulling ().",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&CoexistenceSpectrumChannel::m_cullBeacons),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("PathLoss",
+                     "This trace is fired whenever a new path loss value "
+                     "is calculated. The first and second parameters "
+                     "to the trace are pointers respectively to the TX and "
+                     "RX SpectrumPhy instances, whereas the third parameter "
+                     "is the calculated path loss value in dB",
+                     MakeTraceSourceAccessor (&CoexistenceSpectrumChannel::m_pathLossTrace),
+                     "ns3::SpectrumChannel::LossTracedCallback")
+  ;
+  return tid;
+}
+
+void
+CoexistenceSpectrumChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_propagationLoss = 0;
+  m_propagationDelay = 0;
+  m_spectrumPropagationLoss = 0;
+  m_txModelInfoMap.clear ();
+  m_rxModelInfoMap.clear ();
+  m_pendingCtrlFrames.clear ();
+  m_measuredCells.clear ();
+  m_beaconCulledDevices.clear ();
+  m_numDevices = 0;
+  SpectrumChannel::DoDispose ();
+}
+
+void
+CoexistenceSpectrumChannel::AddPropagationLossModel (Ptr<PropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  NS_ASSERT (m_propagationLoss == 0);
+  m_propagationLoss = loss;
+}
+
+void
+CoexistenceSpectrumChannel::AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  NS_ASSERT (m_spectrumPropagationLoss == 0);
+  m_spectrumPropagationLoss = loss;
+}
+
+bool
+CoexistenceSpectrumChannel::GetFlatSpectrumLossDb (double &lossDb) const
+{
+  // a chain of constant losses is the same on all bands, so it can be
+  // applied as part of the scalar path loss; the chain is walked at
+  // every transmission, since SetNext () can be called at any time
+  lossDb = 0;
+  for (Ptr<SpectrumPropagationLossModel> model = m_spectrumPropagationLoss; model != 0; model = model->GetNext ())
+    {
+      Ptr<ConstantSpectrumPropagationLossModel> constant = DynamicCast<ConstantSpectrumPropagationLossModel> (model);
+      if (constant == 0)
+        {
+          return false;
+        }
+      lossDb += constant->GetLossDb ();
+    }
+  return true;
+}
+
+void
+CoexistenceSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_ASSERT (m_propagationDelay == 0);
+  m_propagationDelay = delay;
+}
+
+Ptr<SpectrumPropagationLossModel>
+CoexistenceSpectrumChannel::GetSpectrumPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_spectrumPropagationLoss;
+}
+
+void
+CoexistenceSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+
+  Ptr<const SpectrumModel> rxSpectrumModel = phy->GetRxSpectrumModel ();
+  NS_ASSERT_MSG (rxSpectrumModel != 0, "phy->GetRxSpectrumModel () returned 0. Please check that the RxSpectrumModel is already set for the phy before calling CoexistenceSpectrumChannel::AddRx (phy)");
+  SpectrumModelUid_t rxSpectrumModelUid = rxSpectrumModel->GetUid ();
+
+  // the phy might have been added before with a different
+  // SpectrumModel, so we look for it in all the receiver lists
+  for (RxModelInfoMap::iterator rxInfoIt = m_rxModelInfoMap.begin ();
+       rxInfoIt != m_rxModelInfoMap.end ();
+       ++rxInfoIt)
+    {
+      std::list<Ptr<SpectrumPhy> >::iterator phyIt = std::find (rxInfoIt->second.m_rxPhys.begin (),
+                                                                rxInfoIt->second.m_rxPhys.end (),
+                                                                phy);
+      if (phyIt != rxInfoIt->second.m_rxPhys.end ())
+        {
+          rxInfoIt->second.m_rxPhys.erase (phyIt);
+          --m_numDevices;
+          break;
+        }
+    }
+
+  RxModelInfoMap::iterator rxInfoIt = m_rxModelInfoMap.find (rxSpectrumModelUid);
+  if (rxInfoIt == m_rxModelInfoMap.end ())
+    {
+      RxModelInfo rxInfo;
+      rxInfo.m_rxSpectrumModel = rxSpectrumModel;
+      rxInfoIt = m_rxModelInfoMap.insert (std::make_pair (rxSpectrumModelUid, rxInfo)).first;
+
+      // create the converters from all the known TX SpectrumModels
+      for (TxModelInfoMap::iterator txInfoIt = m_txModelInfoMap.begin ();
+           txInfoIt != m_txModelInfoMap.end ();
+           ++txInfoIt)
+        {
+          SpectrumModelUid_t txSpectrumModelUid = txInfoIt->first;
+          if (txSpectrumModelUid != rxSpectrumModelUid)
+            {
+              NS_LOG_LOGIC ("creating converter between SpectrumModelUid " << txSpectrumModelUid << " and " << rxSpectrumModelUid);
+              SpectrumConverter converter (txInfoIt->second.m_txSpectrumModel, rxSpectrumModel);
+              txInfoIt->second.m_converters.insert (std::make_pair (rxSpectrumModelUid, converter));
+            }
+        }
+    }
+  rxInfoIt->second.m_rxPhys.push_back (phy);
+  ++m_numDevices;
+}
+
+SpectrumModelUid_t
+CoexistenceSpectrumChannel::AddTxSpectrumModel (Ptr<const SpectrumModel> txSpectrumModel)
+{
+  NS_LOG_FUNCTION (this << txSpectrumModel);
+  SpectrumModelUid_t txSpectrumModelUid = txSpectrumModel->GetUid ();
+  TxModelInfo txInfo;
+  txInfo.m_txSpectrumModel = txSpectrumModel;
+  for (RxModelInfoMap::const_iterator rxInfoIt = m_rxModelInfoMap.begin ();
+       rxInfoIt != m_rxModelInfoMap.end ();
+       ++rxInfoIt)
+    {
+      SpectrumModelUid_t rxSpectrumModelUid = rxInfoIt->first;
+      if (rxSpectrumModelUid != txSpectrumModelUid)
+        {
+          NS_LOG_LOGIC ("creating converter between SpectrumModelUid " << txSpectrumModelUid << " and " << rxSpectrumModelUid);
+          SpectrumConverter converter (txSpectrumModel, rxInfoIt->second.m_rxSpectrumModel);
+          txInfo.m_converters.insert (std::make_pair (rxSpectrumModelUid, converter));
+        }
+    }
+  m_txModelInfoMap.insert (std::make_pair (txSpectrumModelUid, txInfo));
+  return txSpectrumModelUid;
+}
+
+void
+CoexistenceSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
+{
+  NS_LOG_FUNCTION (this << txParams);
+  NS_ASSERT (txParams->txPhy);
+  NS_ASSERT (txParams->psd);
+
+  Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
+  SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid ();
+  NS_LOG_LOGIC ("txSpectrumModelUid " << txSpectrumModelUid);
+
+  TxModelInfoMap::const_iterator txInfoIt = m_txModelInfoMap.find (txSpectrumModelUid);
+  if (txInfoIt == m_txModelInfoMap.end ())
+    {
+      AddTxSpectrumModel (txParams->psd->GetSpectrumModel ());
+      txInfoIt = m_txModelInfoMap.find (txSpectrumModelUid);
+    }
+  ++m_nTransmissions;
+
+  double flatSpectrumLossDb;
+  bool flatSpectrumLoss = GetFlatSpectrumLossDb (flatSpectrumLossDb);
+
+  // in the reduced-signalling mode, DL control frames only reach the
+  // LTE receivers, and the other receivers get the following data frame
+  // with the energy of the control region folded into it
+  bool lteReceiversOnly = false;
+  Ptr<SpectrumSignalParameters> foldedTxParams;
+  // the PSS is hidden from the UEs that do not measure the
+  // transmitting cell
+  Ptr<LteSpectrumSignalParametersDlCtrlFrame> pssParams;
+  if (!m_measuredCells.empty ())
+    {
+      pssParams = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (txParams);
+      if (pssParams && !pssParams->pss)
+        {
+          pssParams = 0;
+        }
+    }
+  bool beacon = m_cullBeacons && !m_beaconCulledDevices.empty () && IsWifiBeacon (txParams);
+  if (m_reducedSignalling)
+    {
+      Ptr<LteSpectrumSignalParametersDlCtrlFrame> ctrlParams = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (txParams);
+      // only the control frames announcing a data frame are held back;
+      // the others, e.g. those of the empty subframes, are delivered to
+      // all the receivers as usual
+      if (ctrlParams && CarriesDlDci (ctrlParams))
+        {
+          lteReceiversOnly = true;
+          m_pendingCtrlFrames[txParams->txPhy] = std::make_pair (txParams, Simulator::Now () + txParams->duration);
+        }
+      else if (DynamicCast<LteSpectrumSignalParametersDataFrame> (txParams))
+        {
+          foldedTxParams = FoldCtrlFrame (txParams);
+        }
+    }
+
+  for (RxModelInfoMap::const_iterator rxInfoIt = m_rxModelInfoMap.begin ();
+       rxInfoIt != m_rxModelInfoMap.end ();
+       ++rxInfoIt)
+    {
+      SpectrumModelUid_t rxSpectrumModelUid = rxInfoIt->first;
+
+      // signal shared by all the receivers using this SpectrumModel;
+      // it is built only if at least one receiver is within range
+      Ptr<SpectrumSignalParameters> sharedTx;
+      // same, for the receivers of the folded data frame
+      Ptr<SpectrumSignalParameters> sharedFolded;
+      // same, for the receivers not measuring the cell
+      Ptr<SpectrumSignalParameters> sharedWithoutPss;
+
+      for (std::list<Ptr<SpectrumPhy> >::const_iterator rxPhyIt = rxInfoIt->second.m_rxPhys.begin ();
+           rxPhyIt != rxInfoIt->second.m_rxPhys.end ();
+           ++rxPhyIt)
+        {
+          if (*rxPhyIt == txParams->txPhy)
+            {
+              continue;
+            }
+          bool lteReceiver = m_reducedSignalling && DynamicCast<LteSpectrumPhy> (*rxPhyIt) != 0;
+          if (lteReceiversOnly && !lteReceiver)
+            {
+              ++m_nSuppressedDeliveries;
+              continue;
+            }
+          if (beacon)
+            {
+              ++m_nBeaconDeliveries;
+              if (IsBeaconCulled (*rxPhyIt))
+                {
+                  ++m_nCulledBeacons;
+                  continue;
+                }
+            }
+
+          Ptr<MobilityModel> receiverMobility = (*rxPhyIt)->GetMobility ();
+          double pathLossDb = 0;
+          if (txMobility && receiverMobility)
+            {
+              pathLossDb = CalcCouplingLossDb (txMobility, txParams->txAntenna,
+                                               receiverMobility, (*rxPhyIt)->GetRxAntenna ());
+              m_pathLossTrace (txParams->txPhy, *rxPhyIt, pathLossDb);
+              if (pathLossDb > m_maxLossDb)
+                {
+                  // beyond range
+                  continue;
+                }
+              if (flatSpectrumLoss)
+                {
+                  // like the frequency-dependent loss, not accounted
+                  // for by MaxLossDb and the PathLoss trace
+                  pathLossDb += flatSpectrumLossDb;
+                }
+            }
+
+          Ptr<SpectrumSignalParameters> shared;
+          if (foldedTxParams != 0 && !lteReceiver)
+            {
+              if (sharedFolded == 0)
+                {
+                  sharedFolded = ConvertSignal (foldedTxParams, txInfoIt->second, rxSpectrumModelUid);
+                }
+              shared = sharedFolded;
+            }
+          else if (pssParams != 0 && !IsMeasuredCell (*rxPhyIt, pssParams->cellId))
+            {
+              if (sharedWithoutPss == 0)
+                {
+                  if (sharedTx == 0)
+                    {
+                      sharedTx = ConvertSignal (txParams, txInfoIt->second, rxSpectrumModelUid);
+                    }
+                  sharedWithoutPss = sharedTx->Copy ();
+                  DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (sharedWithoutPss)->pss = false;
+                }
+              ++m_nPrunedMeasurements;
+              shared = sharedWithoutPss;
+            }
+          else
+            {
+              if (sharedTx == 0)
+                {
+                  sharedTx = ConvertSignal (txParams, txInfoIt->second, rxSpectrumModelUid);
+                }
+              shared = sharedTx;
+            }
+
+          double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+          Ptr<SpectrumSignalParameters> rxParams;
+          Time delay = MicroSeconds (0);
+          if (txMobility && receiverMobility)
+            {
+              if (!flatSpectrumLoss)
+                {
+                  // frequency-selective link: the PSD is evaluated
+                  // now, as MultiModelSpectrumChannel does
+                  rxParams = MaterializeRxParams (shared, pathGainLinear);
+                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+                }
+              if (m_propagationDelay)
+                {
+                  delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+                }
+            }
+
+          ++m_nDeliveries;
+          Ptr<NetDevice> netDev = GetNetDeviceOf (*rxPhyIt);
+          if (netDev)
+            {
+              // the receiver has a NetDevice, so we expect that it is attached to a Node
+              uint32_t dstNode = netDev->GetNode ()->GetId ();
+              Simulator::ScheduleWithContext (dstNode, delay, &CoexistenceSpectrumChannel::StartRx, this,
+                                              shared, rxParams, pathGainLinear, *rxPhyIt);
+            }
+          else
+            {
+              // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+              Simulator::Schedule (delay, &CoexistenceSpectrumChannel::StartRx, this,
+                                   shared, rxParams, pathGainLinear, *rxPhyIt);
+            }
+        }
+    }
+}
+
+Ptr<SpectrumSignalParameters>
+CoexistenceSpectrumChannel::ConvertSignal (Ptr<SpectrumSignalParameters> params,
+                                           const TxModelInfo &txInfo,
+                                           SpectrumModelUid_t rxSpectrumModelUid) const
+{
+  SpectrumModelUid_t txSpectrumModelUid = params->psd->GetSpectrumModelUid ();
+  if (txSpectrumModelUid == rxSpectrumModelUid)
+    {
+      // the transmitter does not modify its parameters after StartTx,
+      // so they can be shared as they are
+      return params;
+    }
+  NS_LOG_LOGIC ("converting txPowerSpectrum SpectrumModelUids " << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
+  ConverterMap::const_iterator convIt = txInfo.m_converters.find (rxSpectrumModelUid);
+  NS_ASSERT (convIt != txInfo.m_converters.end ());
+  Ptr<SpectrumSignalParameters> converted = params->Copy ();
+  converted->psd = convIt->second.Convert (params->psd);
+  return converted;
+}
+
+double
+CoexistenceSpectrumChannel::CalcCouplingLossDb (Ptr<MobilityModel> txMobility, Ptr<AntennaModel> txAntenna,
+                                                Ptr<MobilityModel> rxMobility, Ptr<AntennaModel> rxAntenna) const
+{
+  double pathLossDb = 0;
+  if (txAntenna != 0)
+    {
+      Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+      double txAntennaGain = txAntenna->GetGainDb (txAngles);
+      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+      pathLossDb -= txAntennaGain;
+    }
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (txMobility->GetPosition (), rxMobility->GetPosition ());
+      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+      pathLossDb -= rxAntennaGain;
+    }
+  if (m_propagationLoss)
+    {
+      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+      pathLossDb -= propagationGainDb;
+    }
+  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+  return pathLossDb;
+}
+
+double
+CoexistenceSpectrumChannel::GetCouplingLossDb (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy) const
+{
+  NS_LOG_FUNCTION (this << txPhy << rxPhy);
+  Ptr<MobilityModel> txMobility = txPhy->GetMobility ();
+  Ptr<MobilityModel> rxMobility = rxPhy->GetMobility ();
+  NS_ASSERT_MSG (txMobility && rxMobility, "both PHYs must have a mobility model");
+  // the LTE PHYs use the same antenna for transmission and reception
+  return CalcCouplingLossDb (txMobility, txPhy->GetRxAntenna (), rxMobility, rxPhy->GetRxAntenna ());
+}
+
+double
+CoexistenceSpectrumChannel::GetCouplingLossDb (Ptr<MobilityModel> txMobility, Ptr<MobilityModel> rxMobility) const
+{
+  NS_LOG_FUNCTION (this << txMobility << rxMobility);
+  return CalcCouplingLossDb (txMobility, 0, rxMobility, 0);
+}
+
+bool
+CoexistenceSpectrumChannel::IsWifiBeacon (Ptr<SpectrumSignalParameters> params) const
+{
+  Ptr<WifiSpectrumSignalParameters> wifiParams = DynamicCast<WifiSpectrumSignalParameters> (params);
+  if (wifiParams == 0 || wifiParams->packet == 0)
+    {
+      return false;
+    }
+  // read the frame control and the receiver address from the serialized
+  // header, without deserializing the whole header of every frame
+  uint8_t prefix[BEACON_PREFIX_SIZE];
+  if (wifiParams->packet->CopyData (prefix, BEACON_PREFIX_SIZE) < BEACON_PREFIX_SIZE)
+    {
+      return false;
+    }
+  // protocol version 0, management frame of subtype beacon
+  if (prefix[0] != 0x80)
+    {
+      return false;
+    }
+  // broadcast receiver address, after the frame control and the duration
+  for (uint32_t i = 4; i < BEACON_PREFIX_SIZE; ++i)
+    {
+      if (prefix[i] != 0xff)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+CoexistenceSpectrumChannel::IsBeaconCulled (Ptr<SpectrumPhy> rxPhy) const
+{
+  Ptr<NetDevice> netDev = GetNetDeviceOf (rxPhy);
+  return netDev && m_beaconCulledDevices.find (netDev) != m_beaconCulledDevices.end ();
+}
+
+void
+CoexistenceSpectrumChannel::SetBeaconCulling (Ptr<NetDevice> device, bool cull)
+{
+  NS_LOG_FUNCTION (this << device << cull);
+  if (cull)
+    {
+      m_beaconCulledDevices.insert (device);
+    }
+  else
+    {
+      m_beaconCulledDevices.erase (device);
+    }
+}
+
+void
+CoexistenceSpectrumChannel::SetMeasuredCells (Ptr<SpectrumPhy> rxPhy, const std::set<uint16_t> &cellIds)
+{
+  NS_LOG_FUNCTION (this << rxPhy << cellIds.size ());
+  m_measuredCells[rxPhy] = cellIds;
+}
+
+bool
+CoexistenceSpectrumChannel::IsMeasuredCell (Ptr<SpectrumPhy> rxPhy, uint16_t cellId) const
+{
+  std::map<Ptr<SpectrumPhy>, std::set<uint16_t> >::const_iterator it = m_measuredCells.find (rxPhy);
+  return it == m_measuredCells.end () || it->second.find (cellId) != it->second.end ();
+}
+
+bool
+CoexistenceSpectrumChannel::CarriesDlDci (Ptr<const LteSpectrumSignalParametersDlCtrlFrame> ctrlParams)
+{
+  // LteEnbPhy sends a data frame in every subframe in which it sends a
+  // DL DCI
+  for (std::list<Ptr<LteControlMessage> >::const_iterator it = ctrlParams->ctrlMsgList.begin ();
+       it != ctrlParams->ctrlMsgList.end ();
+       ++it)
+    {
+      if ((*it)->GetMessageType () == LteControlMessage::DL_DCI)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+Ptr<SpectrumSignalParameters>
+CoexistenceSpectrumChannel::FoldCtrlFrame (Ptr<SpectrumSignalParameters> dataParams)
+{
+  PendingCtrlFrameMap::iterator it = m_pendingCtrlFrames.find (dataParams->txPhy);
+  if (it == m_pendingCtrlFrames.end ())
+    {
+      return 0;
+    }
+  Ptr<SpectrumSignalParameters> ctrlParams = it->second.first;
+  Time ctrlEnd = it->second.second;
+  m_pendingCtrlFrames.erase (it);
+  // the control frame is only folded into the data frame of the same
+  // subframe, which starts as soon as the control region ends (the
+  // LTE PHY leaves a gap of 1 ns between the two)
+  Time now = Simulator::Now ();
+  Time ctrlStart = ctrlEnd - ctrlParams->duration;
+  if (now < ctrlEnd || now - ctrlEnd > m_ctrlFoldTolerance
+      || now + dataParams->duration > ctrlStart + MilliSeconds (1)
+      || dataParams->duration.IsZero ()
+      || ctrlParams->psd->GetSpectrumModelUid () != dataParams->psd->GetSpectrumModelUid ())
+    {
+      NS_LOG_LOGIC ("control frame of " << dataParams->txPhy << " not followed by a data frame in the same subframe");
+      return 0;
+    }
+  NS_LOG_LOGIC ("folding control frame of " << dataParams->txPhy << " into data frame");
+  Ptr<SpectrumSignalParameters> folded = dataParams->Copy ();
+  // same energy as the control region, spread over the data frame
+  *(folded->psd) += *(ctrlParams->psd) * (ctrlParams->duration.GetSeconds () / dataParams->duration.GetSeconds ());
+  return folded;
+}
+
+Ptr<SpectrumSignalParameters>
+CoexistenceSpectrumChannel::MaterializeRxParams (Ptr<SpectrumSignalParameters> shared, double gain) const
+{
+  // SpectrumSignalParameters::Copy () also makes a deep copy of the PSD
+  Ptr<SpectrumSignalParameters> rxParams = shared->Copy ();
+  *(rxParams->psd) *= gain;
+  return rxParams;
+}
+
+void
+CoexistenceSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> shared,
+                                     Ptr<SpectrumSignalParameters> rxParams,
+                                     double gain,
+                                     Ptr<SpectrumPhy> receiver)
+{
+  NS_LOG_FUNCTION (this << shared << rxParams << gain << receiver);
+  if (rxParams == 0)
+    {
+      rxParams = MaterializeRxParams (shared, gain);
+    }
+  receiver->StartRx (rxParams);
+}
+
+uint64_t
+CoexistenceSpectrumChannel::GetNTransmissions (void) const
+{
+  return m_nTransmissions;
+}
+
+uint64_t
+CoexistenceSpectrumChannel::GetNDeliveries (void) const
+{
+  return m_nDeliveries;
+}
+
+uint64_t
+CoexistenceSpectrumChannel::GetNSuppressedDeliveries (void) const
+{
+  return m_nSuppressedDeliveries;
+}
+
+uint64_t
+CoexistenceSpectrumChannel::GetNPrunedMeasurements (void) const
+{
+  return m_nPrunedMeasurements;
+}
+
+uint64_t
+CoexistenceSpectrumChannel::GetNBeaconDeliveries (void) const
+{
+  return m_nBeaconDeliveries;
+}
+
+uint64_t
+CoexistenceSpectrumChannel::GetNCulledBeacons (void) const
+{
+  return m_nCulledBeacons;
+}
+
+uint32_t
+CoexistenceSpectrumChannel::GetNDevices (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_numDevices;
+}
+
+Ptr<NetDevice>
+CoexistenceSpectrumChannel::GetDevice (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  NS_ASSERT (i < m_numDevices);
+  // receivers are grouped by SpectrumModel, so this is linear in the
+  // number of receivers; it is not used on the data path
+  uint32_t j = 0;
+  for (RxModelInfoMap::const_iterator rxInfoIt = m_rxModelInfoMap.begin ();
+       rxInfoIt != m_rxModelInfoMap.end ();
+       ++rxInfoIt)
+    {
+      for (std::list<Ptr<SpectrumPhy> >::const_iterator phyIt = rxInfoIt->second.m_rxPhys.begin ();
+           phyIt != rxInfoIt->second.m_rxPhys.end ();
+           ++phyIt)
+        {
+          if (j == i)
+            {
+              return GetNetDeviceOf (*phyIt);
+            }
+          ++j;
+        }
+    }
+  NS_FATAL_ERROR ("m_numDevices > actual number of devices");
+  return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,334 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COEXISTENCE_SPECTRUM_CHANNEL_H
+#define COEXISTENCE_SPECTRUM_CHANNEL_H
+
+#include <ns3/spectrum-channel.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/constant-spectrum-propagation-loss.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/mobility-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/traced-callback.h>
+#include <map>
+#include <set>
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+struct LteSpectrumSignalParametersDlCtrlFrame;
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * A SpectrumChannel supporting multiple SpectrumModels (like
+ * MultiModelSpectrumChannel) which avoids building a full copy of the
+ * transmitted signal for every receiver at StartTx time.
+ *
+ * For each transmission, one immutable copy of the signal is built per
+ * receiver SpectrumModel (converting the PSD if needed) and shared by
+ * reference among all the deliveries to receivers using that model.
+ * When the channel has only frequency-flat loss models, i.e., a
+ * PropagationLossModel and possibly a chain of
+ * ConstantSpectrumPropagationLossModel, whose loss is folded into the
+ * scalar path loss, each pending delivery only carries the linear gain
+ * of its link; the scaled PSD handed to the receiving SpectrumPhy is
+ * materialized when the signal actually reaches it. When any other
+ * SpectrumPropagationLossModel is present, the per-receiver PSD is
+ * computed at StartTx time exactly as MultiModelSpectrumChannel does,
+ * so that random variates are drawn in the same order.
+ *
+ * The transmitting SpectrumPhy is expected not to modify the
+ * SpectrumSignalParameters after StartTx () has returned.
+ *
+ * In the reduced-signalling mode (attribute ReducedSignalling), LTE DL
+ * control frames carrying a DL DCI are only delivered to LTE receivers,
+ * which need them for the DCIs and the RSRP measurements. The other
+ * receivers get the data frame that the eNB sends right after the
+ * control region of such a subframe with the energy of the control
+ * region spread over it, so that the subframe produces a single
+ * reception event at each Wi-Fi device. The data frame must start at
+ * most CtrlFoldTolerance after the end of the control frame and end
+ * within the same subframe. The control frames without a DL DCI, which
+ * are not followed by a data frame, are delivered to all the receivers.
+ *
+ * The cells whose PSS a UE measures can be restricted with
+ * SetMeasuredCells (), typically to the cells of its CSG with the
+ * lowest coupling loss, selected once at setup: the DL control frames
+ * carrying the PSS of the other cells are delivered to the UE with the
+ * PSS flag cleared. The frames are still received as control-region
+ * interference, so only the measurement work is saved.
+ *
+ * In the beacon-culling mode (attribute CullBeacons), Wi-Fi beacons
+ * are not delivered to the devices registered with SetBeaconCulling (),
+ * i.e., the associated STAs. The beacons are recognized from the first
+ * bytes of the serialized MAC header, without deserializing it. The
+ * culled STAs neither decode the beacons nor see them as interference
+ * or as a busy CCA.
+ */
+class CoexistenceSpectrumChannel : public SpectrumChannel
+{
+public:
+  CoexistenceSpectrumChannel ();
+  virtual ~CoexistenceSpectrumChannel ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  // inherited from SpectrumChannel
+  virtual void AddPropagationLossModel (Ptr<PropagationLossModel> loss);
+  virtual void AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss);
+  virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+  virtual void AddRx (Ptr<SpectrumPhy> phy);
+  virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+
+  // inherited from Channel
+  virtual uint32_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+  /**
+   * \return the SpectrumPropagationLossModel used by this channel, if any
+   */
+  virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
+
+  /// \return the number of transmissions started on this channel
+  uint64_t GetNTransmissions (void) const;
+
+  /// \return the number of signal deliveries scheduled to receivers
+  uint64_t GetNDeliveries (void) const;
+
+  /// \return the number of deliveries of control frames suppressed by the reduced-signalling mode
+  uint64_t GetNSuppressedDeliveries (void) const;
+
+  /**
+   * Restrict the cells on whose PSS a UE measures RSRP and RSRQ; the
+   * PSS of the other cells is hidden from it. The UEs for which this is
+   * not called measure all the cells.
+   *
+   * \param rxPhy the DL SpectrumPhy of the UE
+   * \param cellIds the cells measured by the UE
+   */
+  void SetMeasuredCells (Ptr<SpectrumPhy> rxPhy, const std::set<uint16_t> &cellIds);
+
+  /// \return the number of PSS deliveries pruned by SetMeasuredCells ()
+  uint64_t GetNPrunedMeasurements (void) const;
+
+  /**
+   * In the beacon-culling mode, choose whether a device decodes the
+   * Wi-Fi beacons it receives
+   *
+   * \param device the device, typically a STA
+   * \param cull if true, the beacons are not delivered to the device
+   */
+  void SetBeaconCulling (Ptr<NetDevice> device, bool cull);
+
+  /// \return the number of deliveries of Wi-Fi beacons, in the beacon-culling mode
+  uint64_t GetNBeaconDeliveries (void) const;
+
+  /// \return the number of deliveries of Wi-Fi beacons skipped, in the beacon-culling mode
+  uint64_t GetNCulledBeacons (void) const;
+
+  /**
+   * Compute the coupling loss between two PHYs, as done for each
+   * delivery: antenna gains and PropagationLossModel, without the
+   * SpectrumPropagationLossModels. The antenna returned by
+   * GetRxAntenna () is used also as the transmitting one.
+   *
+   * \param txPhy the transmitter
+   * \param rxPhy the receiver
+   * \return the coupling loss in dB
+   */
+  double GetCouplingLossDb (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy) const;
+
+  /**
+   * Compute the propagation loss between two positions, for devices
+   * whose antenna gains are not modelled by an AntennaModel (e.g., the
+   * TxGain and RxGain of the Wi-Fi PHYs)
+   *
+   * \param txMobility the mobility of the transmitter
+   * \param rxMobility the mobility of the receiver
+   * \return the loss in dB
+   */
+  double GetCouplingLossDb (Ptr<MobilityModel> txMobility, Ptr<MobilityModel> rxMobility) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Deliver a signal to a receiver. If rxParams is null, the
+   * per-receiver parameters are built from the shared signal scaled by
+   * the given linear gain.
+   *
+   * \param shared the signal shared by all receivers with the same SpectrumModel
+   * \param rxParams the per-receiver signal, if it was already materialized
+   * \param gain the linear gain of the link (used only if rxParams is null)
+   * \param receiver the receiving SpectrumPhy
+   */
+  void StartRx (Ptr<SpectrumSignalParameters> shared,
+                Ptr<SpectrumSignalParameters> rxParams,
+                double gain,
+                Ptr<SpectrumPhy> receiver);
+
+  /**
+   * \param lossDb the sum of the losses of the chain of
+   * SpectrumPropagationLossModel, if they are all constant
+   * \return whether the chain is empty or only made of
+   * ConstantSpectrumPropagationLossModel
+   */
+  bool GetFlatSpectrumLossDb (double &lossDb) const;
+
+  /**
+   * \param ctrlParams an LTE DL control frame
+   * \return whether the control frame carries a DL DCI, and thus is
+   * followed by a data frame in the same subframe
+   */
+  static bool CarriesDlDci (Ptr<const LteSpectrumSignalParametersDlCtrlFrame> ctrlParams);
+
+  /**
+   * Fold the pending control frame of the transmitter of an LTE data
+   * frame into it
+   *
+   * \param dataParams the data frame
+   * \return a copy of dataParams with the energy of the control frame
+   * added, or 0 if no control frame has just ended
+   */
+  Ptr<SpectrumSignalParameters> FoldCtrlFrame (Ptr<SpectrumSignalParameters> dataParams);
+
+  /**
+   * \param params the parameters of a transmission
+   * \return whether the transmission is a Wi-Fi beacon
+   */
+  bool IsWifiBeacon (Ptr<SpectrumSignalParameters> params) const;
+
+  /**
+   * \param rxPhy a receiver
+   * \return whether the receiver does not decode the Wi-Fi beacons
+   */
+  bool IsBeaconCulled (Ptr<SpectrumPhy> rxPhy) const;
+
+  /**
+   * \param txMobility the mobility of the transmitter
+   * \param txAntenna the antenna of the transmitter, or 0
+   * \param rxMobility the mobility of the receiver
+   * \param rxAntenna the antenna of the receiver, or 0
+   * \return the coupling loss in dB, antenna gains included
+   */
+  double CalcCouplingLossDb (Ptr<MobilityModel> txMobility, Ptr<AntennaModel> txAntenna,
+                             Ptr<MobilityModel> rxMobility, Ptr<AntennaModel> rxAntenna) const;
+
+  /**
+   * \param rxPhy the receiver of a DL control frame carrying the PSS
+   * \param cellId the cell of the transmitter
+   * \return false if the PSS has to be hidden from the receiver
+   */
+  bool IsMeasuredCell (Ptr<SpectrumPhy> rxPhy, uint16_t cellId) const;
+
+  /**
+   * Build the per-receiver signal from a shared one
+   *
+   * \param shared the shared signal
+   * \param gain the linear gain to apply to its PSD
+   * \return a newly allocated copy of shared, with its PSD scaled by gain
+   */
+  Ptr<SpectrumSignalParameters> MaterializeRxParams (Ptr<SpectrumSignalParameters> shared,
+                                                     double gain) const;
+
+  /**
+   * Register a new TX SpectrumModel, creating the converters towards
+   * all the RX SpectrumModels currently known
+   *
+   * \param txSpectrumModel the TX SpectrumModel
+   * \return the UID of txSpectrumModel
+   */
+  SpectrumModelUid_t AddTxSpectrumModel (Ptr<const SpectrumModel> txSpectrumModel);
+
+  /// converters from a TX SpectrumModel, indexed by RX SpectrumModel UID
+  typedef std::map<SpectrumModelUid_t, SpectrumConverter> ConverterMap;
+
+  /// information kept for each TX SpectrumModel
+  struct TxModelInfo
+  {
+    Ptr<const SpectrumModel> m_txSpectrumModel; ///< the SpectrumModel
+    ConverterMap m_converters; ///< converters towards every RX SpectrumModel
+  };
+
+  /// information kept for each RX SpectrumModel
+  struct RxModelInfo
+  {
+    Ptr<const SpectrumModel> m_rxSpectrumModel; ///< the SpectrumModel
+    std::list<Ptr<SpectrumPhy> > m_rxPhys; ///< the receivers using this model
+  };
+
+  typedef std::map<SpectrumModelUid_t, TxModelInfo> TxModelInfoMap;
+  typedef std::map<SpectrumModelUid_t, RxModelInfo> RxModelInfoMap;
+
+  /**
+   * \param params a transmitted signal
+   * \param txInfo the information of the TX SpectrumModel of params
+   * \param rxSpectrumModelUid the UID of the RX SpectrumModel
+   * \return params itself if the two SpectrumModels are the same, or a
+   * copy of params with the PSD converted to the RX SpectrumModel
+   */
+  Ptr<SpectrumSignalParameters> ConvertSignal (Ptr<SpectrumSignalParameters> params,
+                                               const TxModelInfo &txInfo,
+                                               SpectrumModelUid_t rxSpectrumModelUid) const;
+
+  TxModelInfoMap m_txModelInfoMap; ///< TX SpectrumModels seen so far
+  RxModelInfoMap m_rxModelInfoMap; ///< receivers grouped by SpectrumModel
+  uint32_t m_numDevices; ///< number of receivers attached
+
+  double m_maxLossDb; ///< signals with a higher loss are not delivered
+  Ptr<PropagationLossModel> m_propagationLoss; ///< frequency-flat loss
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss; ///< frequency-dependent loss
+  Ptr<PropagationDelayModel> m_propagationDelay; ///< propagation delay
+
+  bool m_reducedSignalling; ///< whether the reduced-signalling mode is enabled
+  /// the last DL control frame of each eNB, with its end time
+  typedef std::map<Ptr<SpectrumPhy>, std::pair<Ptr<SpectrumSignalParameters>, Time> > PendingCtrlFrameMap;
+  PendingCtrlFrameMap m_pendingCtrlFrames; ///< control frames waiting for their data frame
+  uint64_t m_nTransmissions; ///< number of transmissions started
+  uint64_t m_nDeliveries; ///< number of deliveries scheduled
+  uint64_t m_nSuppressedDeliveries; ///< number of control frame deliveries suppressed
+  Time m_ctrlFoldTolerance; ///< maximum gap between a control frame and its data frame
+
+  /// the cells measured by the UEs set with SetMeasuredCells ()
+  std::map<Ptr<SpectrumPhy>, std::set<uint16_t> > m_measuredCells;
+  uint64_t m_nPrunedMeasurements; ///< number of PSS deliveries pruned
+
+  bool m_cullBeacons; ///< whether the beacon-culling mode is enabled
+  std::set<Ptr<NetDevice> > m_beaconCulledDevices; ///< devices not decoding the beacons
+  uint64_t m_nBeaconDeliveries; ///< number of beacon deliveries
+  uint64_t m_nCulledBeacons; ///< number of beacon deliveries skipped
+
+  /// the PathLoss trace source, fired for every (tx, rx) pair evaluated
+  TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double> m_pathLossTrace;
+};
+
+} // namespace ns3
+
+#endif /* COEXISTENCE_SPECTRUM_CHANNEL_H */
@@ -0,0 +1,189 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <ns3/log.h>
+#include <ns3/assert.h>
+#include <ns3/string.h>
+#include <ns3/object-factory.h>
+#include <ns3/global-value.h>
+#include <ns3/type-id.h>
+#include <algorithm>
+
+#include "counting-scheduler.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CountingScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (CountingScheduler);
+
+uint64_t CountingScheduler::g_nInserts = 0;
+uint64_t CountingScheduler::g_nRemoveNexts = 0;
+uint64_t CountingScheduler::g_nRemoves = 0;
+uint64_t CountingScheduler::g_nSameTimeEvents = 0;
+uint64_t CountingScheduler::g_maxSize = 0;
+
+TypeId
+CountingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CountingScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("LaaWifiCoexistence")
+    .AddConstructor<CountingScheduler> ()
+    .AddAttribute ("SchedulerType",
+                   "The type of the Scheduler actually holding the events; "
+                   "if empty, the one selected by the SchedulerType global value.",
+                   StringValue (""),
+                   MakeStringAccessor (&CountingScheduler::SetSchedulerType),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+CountingScheduler::CountingScheduler ()
+  : m_size (0),
+    m_lastTs (0),
+    m_hasLastTs (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CountingScheduler::~CountingScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CountingScheduler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_scheduler = 0;
+  Scheduler::DoDispose ();
+}
+
+void
+CountingScheduler::SetSchedulerType (std::string type)
+{
+  NS_LOG_FUNCTION (this << type);
+  NS_ASSERT_MSG (m_size == 0, "the scheduler type cannot be changed while events are queued");
+  ObjectFactory factory;
+  if (type.empty ())
+    {
+      TypeIdValue schedulerType;
+      GlobalValue::GetValueByName ("SchedulerType", schedulerType);
+      factory.SetTypeId (schedulerType.Get ());
+      if (factory.GetTypeId () == GetTypeId ())
+        {
+          // --SchedulerType=ns3::CountingScheduler: wrap the ns-3 default
+          factory.SetTypeId ("ns3::MapScheduler");
+        }
+    }
+  else
+    {
+      factory.SetTypeId (type);
+    }
+  m_scheduler = factory.Create<Scheduler> ();
+}
+
+void
+CountingScheduler::Insert (const Event &ev)
+{
+  ++g_nInserts;
+  ++m_size;
+  g_maxSize = std::max (g_maxSize, m_size);
+  m_scheduler->Insert (ev);
+}
+
+bool
+CountingScheduler::IsEmpty (void) const
+{
+  return m_scheduler->IsEmpty ();
+}
+
+Scheduler::Event
+CountingScheduler::PeekNext (void) const
+{
+  return m_scheduler->PeekNext ();
+}
+
+Scheduler::Event
+CountingScheduler::RemoveNext (void)
+{
+  ++g_nRemoveNexts;
+  --m_size;
+  Event ev = m_scheduler->RemoveNext ();
+  if (m_hasLastTs && ev.key.m_ts == m_lastTs)
+    {
+      ++g_nSameTimeEvents;
+    }
+  m_lastTs = ev.key.m_ts;
+  m_hasLastTs = true;
+  return ev;
+}
+
+void
+CountingScheduler::Remove (const Event &ev)
+{
+  ++g_nRemoves;
+  --m_size;
+  m_scheduler->Remove (ev);
+}
+
+uint64_t
+CountingScheduler::GetNInserts (void)
+{
+  return g_nInserts;
+}
+
+uint64_t
+CountingScheduler::GetNRemoveNexts (void)
+{
+  return g_nRemoveNexts;
+}
+
+uint64_t
+CountingScheduler::GetNRemoves (void)
+{
+  return g_nRemoves;
+}
+
+uint64_t
+CountingScheduler::GetNSameTimeEvents (void)
+{
+  return g_nSameTimeEvents;
+}
+
+uint64_t
+CountingScheduler::GetMaxSize (void)
+{
+  return g_maxSize;
+}
+
+void
+CountingScheduler::ResetCounters (void)
+{
+  g_nInserts = 0;
+  g_nRemoveNexts = 0;
+  g_nRemoves = 0;
+  g_nSameTimeEvents = 0;
+  g_maxSize = 0;
+}
+
+} // namespace ns3
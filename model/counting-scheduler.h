@@ -0,0 +1,108 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef COUNTING_SCHEDULER_H
+#define COUNTING_SCHEDULER_H
+
+#include <ns3/scheduler.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * A Scheduler counting the operations done on the event queue, and
+ * delegating them to another Scheduler (by default, the one selected by
+ * the SchedulerType global value, i.e., MapScheduler unless configured).
+ *
+ * Besides the number of insertions and removals, it counts the events
+ * executed at the same time as the previous one, e.g., the subframe
+ * events that all the eNBs and UEs schedule on the same 1 ms grid.
+ * This is the number of queue operations that a driver firing a single
+ * event for all of them would save.
+ *
+ * The counters are shared by all the instances, since the simulator
+ * does not give access to its scheduler; they are meant to be read
+ * after Simulator::Run (), with one scheduler per simulation.
+ */
+class CountingScheduler : public Scheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CountingScheduler ();
+  virtual ~CountingScheduler ();
+
+  // inherited from Scheduler
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+  /// \return the number of events inserted
+  static uint64_t GetNInserts (void);
+
+  /// \return the number of events removed to be executed
+  static uint64_t GetNRemoveNexts (void);
+
+  /// \return the number of events removed because they were cancelled
+  static uint64_t GetNRemoves (void);
+
+  /// \return the number of events executed at the same time as the previous one
+  static uint64_t GetNSameTimeEvents (void);
+
+  /// \return the maximum number of events in the queue
+  static uint64_t GetMaxSize (void);
+
+  /// reset all the counters to zero
+  static void ResetCounters (void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Set the type of the Scheduler actually holding the events
+   *
+   * \param type the name of the TypeId, or empty for the type selected
+   * by the SchedulerType global value
+   */
+  void SetSchedulerType (std::string type);
+
+  Ptr<Scheduler> m_scheduler; ///< the Scheduler actually holding the events
+  uint64_t m_size; ///< the number of events in the queue
+  uint64_t m_lastTs; ///< the time stamp of the last event removed by RemoveNext ()
+  bool m_hasLastTs; ///< whether m_lastTs is valid
+
+  static uint64_t g_nInserts; ///< number of insertions
+  static uint64_t g_nRemoveNexts; ///< number of removals for execution
+  static uint64_t g_nRemoves; ///< number of removals of cancelled events
+  static uint64_t g_nSameTimeEvents; ///< events executed at the time of the previous one
+  static uint64_t g_maxSize; ///< maximum queue size
+};
+
+} // namespace ns3
+
+#endif /* COUNTING_SCHEDULER_H */
@@ -0,0 +1,202 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+#include <ns3/pointer.h>
+#include <ns3/node.h>
+#include <ns3/packet.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/regular-wifi-mac.h>
+#include <ns3/edca-txop-n.h>
+#include <ns3/wifi-mac-queue.h>
+#include <algorithm>
+
+#include "full-buffer-wifi-source.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FullBufferWifiSource");
+
+NS_OBJECT_ENSURE_REGISTERED (FullBufferWifiSource);
+
+const uint16_t FullBufferWifiSource::PROT_NUMBER;
+
+TypeId
+FullBufferWifiSource::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FullBufferWifiSource")
+    .SetParent<Application> ()
+    .SetGroupName ("LaaWifiCoexistence")
+    .AddConstructor<FullBufferWifiSource> ()
+    .AddAttribute ("RefillInterval",
+                   "The time between two top-ups of the queue",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&FullBufferWifiSource::m_refillInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("Backlog",
+                   "The number of MPDUs kept queued for each destination, "
+                   "if the queue can hold them for all the destinations",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&FullBufferWifiSource::m_backlog),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("PacketSize",
+                   "The size of the packets",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&FullBufferWifiSource::m_size),
+                   MakeUintegerChecker<uint32_t> (1, 2296))
+  ;
+  return tid;
+}
+
+FullBufferWifiSource::FullBufferWifiSource ()
+  : m_running (false),
+    m_nSent (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FullBufferWifiSource::~FullBufferWifiSource ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FullBufferWifiSource::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_device = 0;
+  m_queue = 0;
+  m_payload = 0;
+  m_sinkNodes.clear ();
+  Application::DoDispose ();
+}
+
+void
+FullBufferWifiSource::SetDevice (Ptr<WifiNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  m_device = device;
+  Ptr<RegularWifiMac> mac = DynamicCast<RegularWifiMac> (device->GetMac ());
+  NS_ASSERT_MSG (mac != 0, "FullBufferWifiSource needs a QoS MAC");
+  PointerValue edca;
+  mac->GetAttribute ("BE_EdcaTxopN", edca);
+  m_queue = edca.Get<EdcaTxopN> ()->GetEdcaQueue ();
+}
+
+Ptr<WifiNetDevice>
+FullBufferWifiSource::GetDevice (void) const
+{
+  return m_device;
+}
+
+void
+FullBufferWifiSource::AddDestination (Ptr<WifiNetDevice> sta)
+{
+  NS_LOG_FUNCTION (this << sta);
+  Mac48Address address = sta->GetMac ()->GetAddress ();
+  if (std::find (m_destinations.begin (), m_destinations.end (), address) == m_destinations.end ())
+    {
+      m_destinations.push_back (address);
+    }
+  Ptr<Node> node = sta->GetNode ();
+  if (m_sinkNodes.insert (node).second)
+    {
+      node->RegisterProtocolHandler (MakeCallback (&FullBufferWifiSource::Receive, this), PROT_NUMBER, sta);
+    }
+}
+
+void
+FullBufferWifiSource::RemoveDestination (Ptr<WifiNetDevice> sta)
+{
+  NS_LOG_FUNCTION (this << sta);
+  std::vector<Mac48Address>::iterator it = std::find (m_destinations.begin (), m_destinations.end (), sta->GetMac ()->GetAddress ());
+  if (it != m_destinations.end ())
+    {
+      m_destinations.erase (it);
+    }
+}
+
+uint64_t
+FullBufferWifiSource::GetRxBytes (Mac48Address sta) const
+{
+  std::map<Mac48Address, uint64_t>::const_iterator it = m_rxBytes.find (sta);
+  return it == m_rxBytes.end () ? 0 : it->second;
+}
+
+uint64_t
+FullBufferWifiSource::GetNSent (void) const
+{
+  return m_nSent;
+}
+
+void
+FullBufferWifiSource::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_device != 0, "the device of the AP has not been set");
+  m_payload = Create<Packet> (m_size);
+  m_running = true;
+  Refill ();
+}
+
+void
+FullBufferWifiSource::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_running = false;
+  Simulator::Cancel (m_refillEvent);
+}
+
+void
+FullBufferWifiSource::Refill (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_destinations.empty ())
+    {
+      // beyond its maximum size the queue drops the MPDUs
+      uint32_t target = std::min (m_backlog, m_queue->GetMaxSize () / static_cast<uint32_t> (m_destinations.size ()));
+      for (std::vector<Mac48Address>::const_iterator it = m_destinations.begin (); it != m_destinations.end (); ++it)
+        {
+          uint32_t queued = m_queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, *it);
+          for (; queued < target; ++queued)
+            {
+              m_device->Send (m_payload->Copy (), *it, PROT_NUMBER);
+              ++m_nSent;
+            }
+        }
+    }
+  m_refillEvent = Simulator::Schedule (m_refillInterval, &FullBufferWifiSource::Refill, this);
+}
+
+void
+FullBufferWifiSource::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                               const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  NS_LOG_FUNCTION (this << device << packet << protocol << from << to << packetType);
+  // the handler is registered by every source serving the STA
+  if (m_running && Mac48Address::ConvertFrom (from) == m_device->GetMac ()->GetAddress ())
+    {
+      m_rxBytes[Mac48Address::ConvertFrom (device->GetAddress ())] += packet->GetSize ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,136 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef FULL_BUFFER_WIFI_SOURCE_H
+#define FULL_BUFFER_WIFI_SOURCE_H
+
+#include <ns3/application.h>
+#include <ns3/event-id.h>
+#include <ns3/ptr.h>
+#include <ns3/nstime.h>
+#include <ns3/mac48-address.h>
+#include <ns3/net-device.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+class Packet;
+class WifiNetDevice;
+class WifiMacQueue;
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * A virtual traffic source keeping the queue of AC_BE of an AP
+ * backlogged for each of its STAs, without any application, IP or
+ * backhaul involvement.
+ *
+ * Every RefillInterval, the source tops up the MPDUs queued for each
+ * destination to Backlog (or to an equal share of the queue, if
+ * smaller), handing the packets directly to the WifiNetDevice of the
+ * AP with the PROT_NUMBER protocol number.  At the STAs, the packets
+ * are delivered by the WifiNetDevice to a protocol handler of the
+ * source, which counts the bytes received from this AP by each
+ * destination while the application is running.
+ */
+class FullBufferWifiSource : public Application
+{
+public:
+  /// the protocol number of the packets (the local experimental EtherType)
+  static const uint16_t PROT_NUMBER = 0x88B5;
+
+  static TypeId GetTypeId (void);
+  FullBufferWifiSource ();
+  virtual ~FullBufferWifiSource ();
+
+  /**
+   * \param device the device of the AP, on the node of the application
+   */
+  void SetDevice (Ptr<WifiNetDevice> device);
+
+  /// \return the device of the AP
+  Ptr<WifiNetDevice> GetDevice (void) const;
+
+  /**
+   * Start sending to a STA, e.g., when it associates with the AP
+   *
+   * \param sta the device of the STA
+   */
+  void AddDestination (Ptr<WifiNetDevice> sta);
+
+  /**
+   * Stop sending to a STA, e.g., when it leaves the AP; the bytes it
+   * received are still counted
+   *
+   * \param sta the device of the STA
+   */
+  void RemoveDestination (Ptr<WifiNetDevice> sta);
+
+  /**
+   * \param sta the address of a STA
+   * \return the bytes received by the STA from this source while running
+   */
+  uint64_t GetRxBytes (Mac48Address sta) const;
+
+  /// \return the number of packets handed to the device
+  uint64_t GetNSent (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /// top up the queue for every destination and reschedule
+  void Refill (void);
+
+  /**
+   * Protocol handler at the STAs
+   *
+   * \param device the device of the STA
+   * \param packet the packet received
+   * \param protocol the protocol number
+   * \param from the sender
+   * \param to the receiver
+   * \param packetType the type of packet
+   */
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType packetType);
+
+  Time m_refillInterval; ///< time between two top-ups of the queue
+  uint32_t m_backlog; ///< MPDUs kept queued for each destination
+  uint32_t m_size; ///< size of the packets
+  Ptr<WifiNetDevice> m_device; ///< the device of the AP
+  Ptr<WifiMacQueue> m_queue; ///< the queue of AC_BE of the AP
+  std::vector<Mac48Address> m_destinations; ///< the STAs served
+  std::set<Ptr<Node> > m_sinkNodes; ///< the nodes on which the protocol handler is registered
+  std::map<Mac48Address, uint64_t> m_rxBytes; ///< bytes received by each STA
+  Ptr<Packet> m_payload; ///< payload copied into every packet
+  bool m_running; ///< whether the application is running
+  uint64_t m_nSent; ///< packets handed to the device
+  EventId m_refillEvent; ///< the next top-up
+};
+
+} // namespace ns3
+
+#endif /* FULL_BUFFER_WIFI_SOURCE_H */
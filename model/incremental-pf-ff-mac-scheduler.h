@@ -0,0 +1,268 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef INCREMENTAL_PF_FF_MAC_SCHEDULER_H
+#define INCREMENTAL_PF_FF_MAC_SCHEDULER_H
+
+#include <ns3/lte-common.h>
+#include <ns3/ff-mac-csched-sap.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <ns3/ff-mac-scheduler.h>
+#include <ns3/lte-amc.h>
+#include <ns3/lte-ffr-sap.h>
+#include <ns3/pf-ff-mac-scheduler.h>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace ns3 {
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * A proportional fair scheduler making the same allocations as
+ * PfFfMacScheduler, with a DL allocation whose cost does not grow with
+ * the number of UEs for every RBG.
+ *
+ * PfFfMacScheduler evaluates, in every subframe, the metric
+ * achievable rate / average throughput of every UE on every free RBG.
+ * This scheduler keeps, for each RBG, the UEs ordered by their metric,
+ * and updates the entries of a UE only when its subband CQIs, its
+ * transmission mode or its average throughput change. The average
+ * throughput of the UEs not served in a subframe decays by the same
+ * factor for all of them, which leaves their order unchanged: the
+ * averages are thus stored divided by the product of the decay factors
+ * (m_dlThroughputScale), and only the UEs served in a subframe get new
+ * metrics. The allocation of a free RBG takes the first eligible UE of
+ * its queue (FFR, HARQ and buffer checks), instead of evaluating them
+ * all. The achievable rate of a CQI on one RBG is read from a table
+ * computed when the cell is configured.
+ *
+ * The UL allocation, HARQ and RACH handling are those of
+ * PfFfMacScheduler. The two schedulers take the same decisions, except
+ * for UEs whose metrics only differ by the rounding of the averages.
+ */
+class IncrementalPfFfMacScheduler : public FfMacScheduler
+{
+public:
+  IncrementalPfFfMacScheduler ();
+  virtual ~IncrementalPfFfMacScheduler ();
+
+  // inherited from Object
+  virtual void DoDispose (void);
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  // inherited from FfMacScheduler
+  virtual void SetFfMacCschedSapUser (FfMacCschedSapUser* s);
+  virtual void SetFfMacSchedSapUser (FfMacSchedSapUser* s);
+  virtual FfMacCschedSapProvider* GetFfMacCschedSapProvider ();
+  virtual FfMacSchedSapProvider* GetFfMacSchedSapProvider ();
+  virtual void SetLteFfrSapProvider (LteFfrSapProvider* s);
+  virtual LteFfrSapUser* GetLteFfrSapUser ();
+
+  friend class MemberCschedSapProvider<IncrementalPfFfMacScheduler>;
+  friend class MemberSchedSapProvider<IncrementalPfFfMacScheduler>;
+
+  /**
+   * \param rnti the RNTI of the UE
+   * \param txMode the new transmission mode of the UE
+   */
+  void TransmissionModeConfigurationUpdate (uint16_t rnti, uint8_t txMode);
+
+private:
+  // Implementation of the CSCHED API primitives
+  void DoCschedCellConfigReq (const struct FfMacCschedSapProvider::CschedCellConfigReqParameters& params);
+  void DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params);
+  void DoCschedLcConfigReq (const struct FfMacCschedSapProvider::CschedLcConfigReqParameters& params);
+  void DoCschedLcReleaseReq (const struct FfMacCschedSapProvider::CschedLcReleaseReqParameters& params);
+  void DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::CschedUeReleaseReqParameters& params);
+
+  // Implementation of the SCHED API primitives
+  void DoSchedDlRlcBufferReq (const struct FfMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+  void DoSchedDlPagingBufferReq (const struct FfMacSchedSapProvider::SchedDlPagingBufferReqParameters& params);
+  void DoSchedDlMacBufferReq (const struct FfMacSchedSapProvider::SchedDlMacBufferReqParameters& params);
+  void DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::SchedDlTriggerReqParameters& params);
+  void DoSchedDlRachInfoReq (const struct FfMacSchedSapProvider::SchedDlRachInfoReqParameters& params);
+  void DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
+  void DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::SchedUlTriggerReqParameters& params);
+  void DoSchedUlNoiseInterferenceReq (const struct FfMacSchedSapProvider::SchedUlNoiseInterferenceReqParameters& params);
+  void DoSchedUlSrInfoReq (const struct FfMacSchedSapProvider::SchedUlSrInfoReqParameters& params);
+  void DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
+  void DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
+
+  /**
+   * \param dlbandwidth the DL bandwidth in RBs
+   * \return the RBG size of allocation type 0
+   */
+  int GetRbgSize (int dlbandwidth);
+
+  /**
+   * \param rnti the RNTI of the UE
+   * \return the number of logical channels of the UE with data to send
+   */
+  int LcActivePerFlow (uint16_t rnti);
+
+  /**
+   * \param rnti the RNTI of the UE
+   * \param rb the RB
+   * \return the SINR estimated for the RB from the UL CQIs of the UE
+   */
+  double EstimateUlSinr (uint16_t rnti, uint16_t rb);
+
+  /// decrement the DL CQI timers, and remove the expired CQIs
+  void RefreshDlCqiMaps (void);
+  /// decrement the UL CQI timers, and remove the expired CQIs
+  void RefreshUlCqiMaps (void);
+
+  /**
+   * \param rnti the RNTI of the UE
+   * \param lcid the logical channel
+   * \param size the size of the transmission opportunity
+   */
+  void UpdateDlRlcBufferInfo (uint16_t rnti, uint8_t lcid, uint16_t size);
+  /**
+   * \param rnti the RNTI of the UE
+   * \param size the size of the UL grant
+   */
+  void UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size);
+
+  /**
+   * \param rnti the RNTI of the UE
+   * \return the id of the next DL HARQ process, which is marked as busy
+   */
+  uint8_t UpdateHarqProcessId (uint16_t rnti);
+  /**
+   * \param rnti the RNTI of the UE
+   * \return whether the UE has a DL HARQ process available
+   */
+  bool HarqProcessAvailability (uint16_t rnti);
+  /// increment the DL HARQ timers, and free the processes timed out
+  void RefreshHarqProcesses ();
+
+  /**
+   * Recompute the metrics of a UE on all the RBGs, and move its entries
+   * in the RBG queues accordingly
+   *
+   * \param rnti the RNTI of the UE
+   */
+  void UpdateDlMetrics (uint16_t rnti);
+  /**
+   * Remove a UE from the RBG queues
+   *
+   * \param rnti the RNTI of the UE
+   */
+  void RemoveDlMetrics (uint16_t rnti);
+  /// apply m_dlThroughputScale to the stored averages and reset it to 1
+  void RescaleDlThroughput (void);
+
+  /// an entry of the queue of an RBG
+  struct RbgMetric
+  {
+    /**
+     * \param m the metric
+     * \param r the RNTI
+     */
+    RbgMetric (double m, uint16_t r)
+      : metric (m),
+        rnti (r)
+    {
+    }
+    double metric; ///< achievable rate / average throughput, up to m_dlThroughputScale
+    uint16_t rnti; ///< the RNTI of the UE
+    /**
+     * Order the UEs by decreasing metric, then by increasing RNTI, as
+     * PfFfMacScheduler does
+     *
+     * \param other another entry
+     * \return whether this entry comes first
+     */
+    bool operator< (const RbgMetric &other) const;
+  };
+
+  /// the UEs eligible for an RBG, best first
+  typedef std::set<RbgMetric> RbgQueue;
+
+  Ptr<LteAmc> m_amc; ///< the AMC model
+
+  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> m_rlcBufferReq; ///< the DL RLC buffer status
+
+  /**
+   * DL throughput statistics of the UEs; lastAveragedThroughput is
+   * stored divided by m_dlThroughputScale
+   */
+  std::map <uint16_t, pfsFlowPerf_t> m_flowStatsDl;
+  std::map <uint16_t, pfsFlowPerf_t> m_flowStatsUl; ///< UL throughput statistics of the UEs
+  double m_dlThroughputScale; ///< product of the decay factors of the DL averages since the last rescaling
+
+  std::vector<RbgQueue> m_rbgQueues; ///< the queue of each RBG
+  std::map <uint16_t, std::vector<double> > m_dlMetrics; ///< the metric of each UE on each RBG, 0 if not queued
+  std::vector<double> m_cqiRates; ///< the achievable rate on one RBG and one layer, for each CQI
+  double m_noCqiRate; ///< the achievable rate on one RBG and one layer without CQI
+
+  std::map <uint16_t,uint8_t> m_p10CqiRxed; ///< the wideband DL CQIs received
+  std::map <uint16_t,uint32_t> m_p10CqiTimers; ///< the timers of the wideband DL CQIs
+  std::map <uint16_t,SbMeasResult_s> m_a30CqiRxed; ///< the subband DL CQIs received
+  std::map <uint16_t,uint32_t> m_a30CqiTimers; ///< the timers of the subband DL CQIs
+
+  std::map <uint16_t, std::vector <uint16_t> > m_allocationMaps; ///< the UL allocations per subframe, to map the PUSCH CQIs
+  std::map <uint16_t, std::vector <double> > m_ueCqi; ///< the UL SINR of each UE per RB
+  std::map <uint16_t, uint32_t> m_ueCqiTimers; ///< the timers of the UL CQIs
+
+  std::map <uint16_t,uint32_t> m_ceBsrRxed; ///< the UL buffer status of the UEs
+
+  FfMacCschedSapUser* m_cschedSapUser; ///< CSCHED SAP user
+  FfMacSchedSapUser* m_schedSapUser; ///< SCHED SAP user
+  FfMacCschedSapProvider* m_cschedSapProvider; ///< CSCHED SAP provider
+  FfMacSchedSapProvider* m_schedSapProvider; ///< SCHED SAP provider
+
+  LteFfrSapUser* m_ffrSapUser; ///< FFR SAP user
+  LteFfrSapProvider* m_ffrSapProvider; ///< FFR SAP provider
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters m_cschedCellConfig; ///< the cell configuration
+
+  double m_timeWindow; ///< the time window of the average throughputs, in TTIs
+  uint16_t m_nextRntiUl; ///< the RNTI of the next UE to be allocated in the UL
+  uint32_t m_cqiTimersThreshold; ///< the number of TTIs a CQI is valid
+  std::map <uint16_t,uint8_t> m_uesTxMode; ///< the transmission mode of the UEs
+
+  bool m_harqOn; ///< whether HARQ is enabled
+  std::map <uint16_t, uint8_t> m_dlHarqCurrentProcessId; ///< the current DL HARQ process of the UEs
+  std::map <uint16_t, DlHarqProcessesStatus_t> m_dlHarqProcessesStatus; ///< the status of the DL HARQ processes
+  std::map <uint16_t, DlHarqProcessesTimer_t> m_dlHarqProcessesTimer; ///< the timers of the DL HARQ processes
+  std::map <uint16_t, DlHarqProcessesDciBuffer_t> m_dlHarqProcessesDciBuffer; ///< the DCIs of the DL HARQ processes
+  std::map <uint16_t, DlHarqRlcPduListBuffer_t> m_dlHarqProcessesRlcPduListBuffer; ///< the RLC PDUs of the DL HARQ processes
+  std::vector <DlInfoListElement_s> m_dlInfoListBuffered; ///< the DL HARQ retransmissions not done yet
+
+  std::map <uint16_t, uint8_t> m_ulHarqCurrentProcessId; ///< the current UL HARQ process of the UEs
+  std::map <uint16_t, UlHarqProcessesStatus_t> m_ulHarqProcessesStatus; ///< the status of the UL HARQ processes
+  std::map <uint16_t, UlHarqProcessesDciBuffer_t> m_ulHarqProcessesDciBuffer; ///< the DCIs of the UL HARQ processes
+
+  std::vector <struct RachListElement_s> m_rachList; ///< the RACH requests to serve
+  std::vector <uint16_t> m_rachAllocationMap; ///< the UL RBs allocated to the RACH grants
+  uint8_t m_ulGrantMcs; ///< the MCS of the UL grants of the RACH
+};
+
+} // namespace ns3
+
+#endif /* INCREMENTAL_PF_FF_MAC_SCHEDULER_H */
@@ -0,0 +1,237 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <cmath>
+#include <algorithm>
+
+#include "lte-mi-cache.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteMiCache");
+
+/// quantized SINRs are clamped to this range (dB)
+static const double MIN_SINR_DB = -50.0;
+static const double MAX_SINR_DB = 60.0;
+
+LteMiCache::LteMiCache (double quantizationDb, uint32_t maxEntries)
+  : m_quantizationDb (quantizationDb),
+    m_maxEntries (maxEntries),
+    m_hits (0),
+    m_misses (0)
+{
+  NS_LOG_FUNCTION (this << quantizationDb << maxEntries);
+  NS_ASSERT (quantizationDb >= 0);
+}
+
+/// FNV-1a offset basis and prime, to hash the quantized SINRs
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static uint64_t
+HashWord (uint64_t hash, uint32_t word)
+{
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      hash ^= (word >> (8 * i)) & 0xff;
+      hash *= FNV_PRIME;
+    }
+  return hash;
+}
+
+uint64_t
+LteMiCache::Quantize (const SpectrumValue &sinr, const std::vector<int> *map, uint64_t seed)
+{
+  uint32_t nRbs = sinr.GetSpectrumModel ()->GetNumBands ();
+  uint32_t nQuantized = map ? map->size () : nRbs;
+  uint64_t hash = HashWord (HashWord (FNV_OFFSET_BASIS, seed), seed >> 32);
+  m_levels.clear ();
+  for (uint32_t i = 0; i < nQuantized; ++i)
+    {
+      int rb = map ? (*map)[i] : i;
+      double sinrDb = 10 * std::log10 (sinr[rb]);
+      sinrDb = std::min (std::max (sinrDb, MIN_SINR_DB), MAX_SINR_DB);
+      int32_t level = static_cast<int32_t> (std::floor (sinrDb / m_quantizationDb + 0.5));
+      m_levels.push_back (level);
+      hash = HashWord (hash, level);
+    }
+  return hash;
+}
+
+SpectrumValue
+LteMiCache::GetQuantizedSinr (const SpectrumValue &sinr, const std::vector<int> *map) const
+{
+  SpectrumValue quantizedSinr (sinr);
+  for (uint32_t i = 0; i < m_levels.size (); ++i)
+    {
+      int rb = map ? (*map)[i] : i;
+      quantizedSinr[rb] = std::pow (10.0, m_levels[i] * m_quantizationDb / 10.0);
+    }
+  return quantizedSinr;
+}
+
+template <class T>
+const LteMiCache::Entry<T> *
+LteMiCache::Find (const std::map<uint64_t, Entry<T> > &cache, uint64_t key) const
+{
+  typename std::map<uint64_t, Entry<T> >::const_iterator it = cache.find (key);
+  // on a hash collision, the entry is replaced by the result for m_levels
+  if (it == cache.end () || it->second.m_levels != m_levels)
+    {
+      return 0;
+    }
+  return &it->second;
+}
+
+template <class T>
+void
+LteMiCache::Insert (std::map<uint64_t, Entry<T> > &cache, uint64_t key, const T &value)
+{
+  Entry<T> &entry = cache[key];
+  entry.m_levels = m_levels;
+  entry.m_value = value;
+}
+
+void
+LteMiCache::CheckSize (void)
+{
+  if (m_mibCache.size () + m_tbStatsCache.size () + m_cqiCache.size () + m_countedCqiLookups.size () >= m_maxEntries)
+    {
+      NS_LOG_LOGIC ("flushing " << this);
+      m_mibCache.clear ();
+      m_tbStatsCache.clear ();
+      m_cqiCache.clear ();
+      m_countedCqiLookups.clear ();
+    }
+}
+
+double
+LteMiCache::Mib (const SpectrumValue &sinr, const std::vector<int> &map, uint8_t mcs)
+{
+  NS_LOG_FUNCTION (this << mcs);
+  if (m_quantizationDb == 0)
+    {
+      ++m_misses;
+      return LteMiErrorModel::Mib (sinr, map, mcs);
+    }
+  uint64_t key = Quantize (sinr, &map, mcs);
+  const Entry<double> *entry = Find (m_mibCache, key);
+  if (entry)
+    {
+      ++m_hits;
+      return entry->m_value;
+    }
+  ++m_misses;
+  CheckSize ();
+  double mib = LteMiErrorModel::Mib (GetQuantizedSinr (sinr, &map), map, mcs);
+  Insert (m_mibCache, key, mib);
+  return mib;
+}
+
+TbStats_t
+LteMiCache::GetTbDecodificationStats (const SpectrumValue &sinr, const std::vector<int> &map,
+                                      uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory)
+{
+  NS_LOG_FUNCTION (this << size << mcs);
+  if (m_quantizationDb == 0 || !miHistory.empty ())
+    {
+      ++m_misses;
+      return LteMiErrorModel::GetTbDecodificationStats (sinr, map, size, mcs, miHistory);
+    }
+  uint64_t key = Quantize (sinr, &map, (static_cast<uint64_t> (size) << 8) | mcs);
+  const Entry<TbStats_t> *entry = Find (m_tbStatsCache, key);
+  if (entry)
+    {
+      ++m_hits;
+      return entry->m_value;
+    }
+  ++m_misses;
+  CheckSize ();
+  TbStats_t stats = LteMiErrorModel::GetTbDecodificationStats (GetQuantizedSinr (sinr, &map),
+                                                               map, size, mcs, miHistory);
+  Insert (m_tbStatsCache, key, stats);
+  return stats;
+}
+
+std::vector<int>
+LteMiCache::CreateCqiFeedbacks (Ptr<LteAmc> amc, const SpectrumValue &sinr, uint8_t rbgSize)
+{
+  NS_LOG_FUNCTION (this << amc << (uint16_t) rbgSize);
+  if (m_quantizationDb == 0)
+    {
+      ++m_misses;
+      return amc->CreateCqiFeedbacks (sinr, rbgSize);
+    }
+  // the CQIs also depend on the AMC model of amc, which is fixed
+  // during a simulation, so it is not part of the key
+  uint64_t key = Quantize (sinr, 0, rbgSize);
+  const Entry<std::vector<int> > *entry = Find (m_cqiCache, key);
+  if (entry)
+    {
+      ++m_hits;
+      return entry->m_value;
+    }
+  ++m_misses;
+  CheckSize ();
+  std::vector<int> cqi = amc->CreateCqiFeedbacks (GetQuantizedSinr (sinr, 0), rbgSize);
+  Insert (m_cqiCache, key, cqi);
+  return cqi;
+}
+
+void
+LteMiCache::CountCqiLookup (const SpectrumValue &sinr)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_quantizationDb == 0)
+    {
+      ++m_misses;
+      return;
+    }
+  uint64_t key = Quantize (sinr, 0, 0);
+  if (Find (m_countedCqiLookups, key))
+    {
+      ++m_hits;
+      return;
+    }
+  ++m_misses;
+  CheckSize ();
+  Insert (m_countedCqiLookups, key, true);
+}
+
+uint64_t
+LteMiCache::GetHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+LteMiCache::GetMisses (void) const
+{
+  return m_misses;
+}
+
+double
+LteMiCache::GetHitRate (void) const
+{
+  uint64_t lookups = m_hits + m_misses;
+  return lookups ? static_cast<double> (m_hits) / lookups : 0.0;
+}
+
+} // namespace ns3
@@ -0,0 +1,185 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_MI_CACHE_H
+#define LTE_MI_CACHE_H
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/ptr.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/lte-mi-error-model.h>
+#include <ns3/lte-amc.h>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * A memo cache of the LTE link-to-system mapping (LteMiErrorModel) and of
+ * the CQI generation (LteAmc), keyed by the SINR quantized in dB.
+ *
+ * In the static coexistence topologies, the SINR of each UE only takes a
+ * few distinct levels over time (depending on whether the ABS pattern
+ * and the Wi-Fi interferers are on or off), so the same mutual
+ * information and CQI evaluations are repeated every subframe. With a
+ * quantization step q > 0, the SINR of each RB is rounded to the
+ * nearest multiple of q dB, and the result is computed once per distinct
+ * quantized SINR vector, on the quantized SINR itself, so that it does
+ * not depend on the order of the lookups. The quantized SINR is hashed
+ * into the key of the cache, and is only built as a SpectrumValue when
+ * the result has to be computed. With q = 0 (exact mode) every call is
+ * forwarded to the LTE module unchanged. Decoding statistics of HARQ
+ * retransmissions depend on the history of the process and are never
+ * cached.
+ *
+ * The LTE PHYs call LteMiErrorModel and LteAmc directly, so the cache
+ * cannot be used by them from this module. CountCqiLookup () estimates
+ * the hit rate the cache would have for the CQIs of a PHY, from the
+ * SINRs it receives, without computing the CQIs.
+ */
+class LteMiCache : public SimpleRefCount<LteMiCache>
+{
+public:
+  /**
+   * \param quantizationDb the SINR quantization step in dB, 0 for the
+   * exact mode
+   * \param maxEntries the cache is flushed when it grows beyond this
+   * number of entries
+   */
+  LteMiCache (double quantizationDb = 0, uint32_t maxEntries = 100000);
+
+  /**
+   * Memoized LteMiErrorModel::Mib ()
+   *
+   * \param sinr the SINR per RB
+   * \param map the RBs of the transport block
+   * \param mcs the MCS
+   * \return the mean mutual information per bit
+   */
+  double Mib (const SpectrumValue &sinr, const std::vector<int> &map, uint8_t mcs);
+
+  /**
+   * Memoized LteMiErrorModel::GetTbDecodificationStats ()
+   *
+   * \param sinr the SINR per RB
+   * \param map the RBs of the transport block
+   * \param size the size of the transport block in bytes
+   * \param mcs the MCS
+   * \param miHistory the HARQ history of the transport block
+   * \return the TB error rate and the mutual information
+   */
+  TbStats_t GetTbDecodificationStats (const SpectrumValue &sinr, const std::vector<int> &map,
+                                      uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory);
+
+  /**
+   * Memoized LteAmc::CreateCqiFeedbacks ()
+   *
+   * \param amc the LteAmc used to compute the CQIs
+   * \param sinr the SINR per RB
+   * \param rbgSize the RBG size
+   * \return the CQI per RB
+   */
+  std::vector<int> CreateCqiFeedbacks (Ptr<LteAmc> amc, const SpectrumValue &sinr, uint8_t rbgSize = 0);
+
+  /**
+   * Count a CreateCqiFeedbacks () lookup, without computing the CQIs: a
+   * hit if the same quantized SINR was counted before, a miss
+   * otherwise (always, in the exact mode)
+   *
+   * \param sinr the SINR per RB
+   */
+  void CountCqiLookup (const SpectrumValue &sinr);
+
+  /// \return the number of lookups answered from the cache
+  uint64_t GetHits (void) const;
+
+  /// \return the number of lookups that had to be computed
+  uint64_t GetMisses (void) const;
+
+  /// \return the fraction of the lookups answered from the cache
+  double GetHitRate (void) const;
+
+private:
+  /// a cached result, with the quantized SINRs it was computed from
+  template <class T>
+  struct Entry
+  {
+    std::vector<int32_t> m_levels; ///< the quantized SINRs, in quantization steps
+    T m_value; ///< the result
+  };
+
+  /**
+   * Quantize the SINR of some RBs into m_levels, and hash them
+   *
+   * \param sinr the SINR per RB
+   * \param map the RBs to be quantized, or 0 for all the RBs
+   * \param seed the fields other than the SINR the result depends on
+   * \return the key of the quantized SINR
+   */
+  uint64_t Quantize (const SpectrumValue &sinr, const std::vector<int> *map, uint64_t seed);
+
+  /**
+   * Build the SINR a result is computed from, from m_levels
+   *
+   * \param sinr the SINR per RB
+   * \param map the quantized RBs, or 0 for all the RBs
+   * \return sinr, with the SINR of the quantized RBs replaced by their
+   * quantized values
+   */
+  SpectrumValue GetQuantizedSinr (const SpectrumValue &sinr, const std::vector<int> *map) const;
+
+  /**
+   * Look up the result for m_levels
+   *
+   * \param cache the cache
+   * \param key the key returned by Quantize ()
+   * \return the entry, or 0 if it is not cached
+   */
+  template <class T>
+  const Entry<T> * Find (const std::map<uint64_t, Entry<T> > &cache, uint64_t key) const;
+
+  /**
+   * Cache the result for m_levels
+   *
+   * \param cache the cache
+   * \param key the key returned by Quantize ()
+   * \param value the result
+   */
+  template <class T>
+  void Insert (std::map<uint64_t, Entry<T> > &cache, uint64_t key, const T &value);
+
+  /// flush the cache if it is full
+  void CheckSize (void);
+
+  double m_quantizationDb; ///< quantization step in dB, 0 for the exact mode
+  uint32_t m_maxEntries; ///< maximum number of entries in the cache
+  std::map<uint64_t, Entry<double> > m_mibCache; ///< cached Mib () results
+  std::map<uint64_t, Entry<TbStats_t> > m_tbStatsCache; ///< cached GetTbDecodificationStats () results
+  std::map<uint64_t, Entry<std::vector<int> > > m_cqiCache; ///< cached CreateCqiFeedbacks () results
+  std::map<uint64_t, Entry<bool> > m_countedCqiLookups; ///< quantized SINRs seen by CountCqiLookup ()
+  std::vector<int32_t> m_levels; ///< the quantized SINR of the current lookup
+  uint64_t m_hits; ///< lookups answered from the cache
+  uint64_t m_misses; ///< lookups computed
+};
+
+} // namespace ns3
+
+#endif /* LTE_MI_CACHE_H */
@@ -0,0 +1,275 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/node.h>
+#include <ns3/mobility-model.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mmap-trace-fading-loss-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmapTraceFadingLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (MmapTraceFadingLossModel);
+
+/// identifies a trace file, and the version of its layout
+static const char TRACE_FILE_MAGIC[8] = { 'L', 'A', 'A', 'F', 'A', 'D', '1', '\0' };
+
+/**
+ * Layout of a trace file: this header, followed by nSamples rows of
+ * nFrequencies linear gains stored as floats, in native byte order
+ */
+struct TraceFileHeader
+{
+  char magic[8]; ///< TRACE_FILE_MAGIC
+  uint32_t nSamples; ///< number of time samples
+  uint32_t nFrequencies; ///< number of points of the frequency grid
+  int64_t sampleInterval; ///< time between two samples, in nanoseconds
+  double startFrequency; ///< first point of the frequency grid (Hz)
+  double frequencyStep; ///< spacing of the frequency grid (Hz)
+};
+
+
+MmapTraceFadingLossModel::MmapTraceFadingLossModel ()
+  : m_mapped (0),
+    m_mappedLength (0),
+    m_gains (0),
+    m_nSamples (0),
+    m_nFrequencies (0),
+    m_startFrequency (0),
+    m_frequencyStep (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MmapTraceFadingLossModel::~MmapTraceFadingLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+  UnmapTrace ();
+}
+
+TypeId
+MmapTraceFadingLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MmapTraceFadingLossModel")
+    .SetParent<SpectrumPropagationLossModel> ()
+    .SetGroupName ("LaaWifiCoexistence")
+    .AddConstructor<MmapTraceFadingLossModel> ()
+    .AddAttribute ("TraceFilename",
+                   "Name of the trace file, built with "
+                   "MmapTraceFadingLossModel::WriteTraceFile ()",
+                   StringValue (""),
+                   MakeStringAccessor (&MmapTraceFadingLossModel::m_traceFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+void
+MmapTraceFadingLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  UnmapTrace ();
+  m_columns.clear ();
+  m_linkOffsets.clear ();
+  SpectrumPropagationLossModel::DoDispose ();
+}
+
+bool
+MmapTraceFadingLossModel::WriteTraceFile (std::string asciiFile, std::string traceFile,
+                                          uint32_t nFrequencies, uint32_t nSamples, Time sampleInterval,
+                                          double startFrequency, double frequencyStep)
+{
+  NS_LOG_FUNCTION (asciiFile << traceFile << nFrequencies << nSamples << sampleInterval
+                             << startFrequency << frequencyStep);
+  std::ifstream in (asciiFile.c_str ());
+  if (!in.good ())
+    {
+      NS_LOG_WARN ("could not open " << asciiFile);
+      return false;
+    }
+  // the ASCII trace is frequency-major, the trace file time-major
+  std::vector<float> gains (static_cast<size_t> (nSamples) * nFrequencies);
+  for (uint32_t f = 0; f < nFrequencies; ++f)
+    {
+      for (uint32_t t = 0; t < nSamples; ++t)
+        {
+          double gainDb;
+          if (!(in >> gainDb))
+            {
+              NS_LOG_WARN ("trace " << asciiFile << " is too short");
+              return false;
+            }
+          gains[static_cast<size_t> (t) * nFrequencies + f] = std::pow (10.0, gainDb / 10.0);
+        }
+    }
+
+  TraceFileHeader header;
+  std::memcpy (header.magic, TRACE_FILE_MAGIC, sizeof (TRACE_FILE_MAGIC));
+  header.nSamples = nSamples;
+  header.nFrequencies = nFrequencies;
+  header.sampleInterval = sampleInterval.GetNanoSeconds ();
+  header.startFrequency = startFrequency;
+  header.frequencyStep = frequencyStep;
+
+  std::ostringstream tmpFile;
+  tmpFile << traceFile << ".tmp." << getpid ();
+  std::ofstream out (tmpFile.str ().c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  out.write (reinterpret_cast<const char *> (&gains[0]), gains.size () * sizeof (float));
+  out.close ();
+  // processes mapping the file either see the old one or the complete new one
+  if (!out || std::rename (tmpFile.str ().c_str (), traceFile.c_str ()) != 0)
+    {
+      NS_LOG_WARN ("could not write " << traceFile);
+      std::remove (tmpFile.str ().c_str ());
+      return false;
+    }
+  return true;
+}
+
+void
+MmapTraceFadingLossModel::LoadTrace (void) const
+{
+  if (m_gains != 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_traceFile);
+  int fd = open (m_traceFile.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd < 0, "could not open fading trace " << m_traceFile);
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) != 0 || st.st_size < static_cast<off_t> (sizeof (TraceFileHeader)),
+                   "invalid fading trace " << m_traceFile);
+  size_t length = st.st_size;
+  void *addr = mmap (0, length, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid after the file is closed
+  close (fd);
+  NS_ABORT_MSG_IF (addr == MAP_FAILED, "could not map fading trace " << m_traceFile);
+
+  const TraceFileHeader *header = static_cast<const TraceFileHeader *> (addr);
+  if (std::memcmp (header->magic, TRACE_FILE_MAGIC, sizeof (TRACE_FILE_MAGIC)) != 0
+      || header->nSamples == 0 || header->nFrequencies == 0 || header->sampleInterval <= 0
+      || length != sizeof (TraceFileHeader) + static_cast<size_t> (header->nSamples) * header->nFrequencies * sizeof (float))
+    {
+      munmap (addr, length);
+      NS_FATAL_ERROR ("invalid fading trace " << m_traceFile);
+    }
+  m_mapped = addr;
+  m_mappedLength = length;
+  m_gains = reinterpret_cast<const float *> (header + 1);
+  m_nSamples = header->nSamples;
+  m_nFrequencies = header->nFrequencies;
+  m_sampleInterval = NanoSeconds (header->sampleInterval);
+  m_startFrequency = header->startFrequency;
+  m_frequencyStep = header->frequencyStep;
+  NS_LOG_LOGIC ("mapped " << m_nSamples << " samples of " << m_nFrequencies << " frequencies from " << m_traceFile);
+}
+
+void
+MmapTraceFadingLossModel::UnmapTrace (void) const
+{
+  if (m_mapped != 0)
+    {
+      munmap (m_mapped, m_mappedLength);
+      m_mapped = 0;
+      m_mappedLength = 0;
+      m_gains = 0;
+    }
+}
+
+const std::vector<uint32_t> &
+MmapTraceFadingLossModel::GetColumns (Ptr<const SpectrumModel> model) const
+{
+  std::map<SpectrumModelUid_t, std::vector<uint32_t> >::const_iterator it = m_columns.find (model->GetUid ());
+  if (it != m_columns.end ())
+    {
+      return it->second;
+    }
+  std::vector<uint32_t> &columns = m_columns[model->GetUid ()];
+  for (Bands::const_iterator bit = model->Begin (); bit != model->End (); ++bit)
+    {
+      double column = std::floor ((bit->fc - m_startFrequency) / m_frequencyStep);
+      column = std::min (std::max (column, 0.0), m_nFrequencies - 1.0);
+      columns.push_back (static_cast<uint32_t> (column));
+    }
+  return columns;
+}
+
+uint32_t
+MmapTraceFadingLossModel::GetLinkOffset (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const
+{
+  LoadTrace ();
+  std::pair<const MobilityModel *, const MobilityModel *> link (PeekPointer (a), PeekPointer (b));
+  std::map<std::pair<const MobilityModel *, const MobilityModel *>, uint32_t>::const_iterator it = m_linkOffsets.find (link);
+  if (it != m_linkOffsets.end ())
+    {
+      return it->second;
+    }
+  Ptr<Node> nodeA = a->GetObject<Node> ();
+  Ptr<Node> nodeB = b->GetObject<Node> ();
+  uint64_t idA = nodeA ? nodeA->GetId () + 1 : 0;
+  uint64_t idB = nodeB ? nodeB->GetId () + 1 : 0;
+  // same offset in both directions; the mixing spreads the links of
+  // neighbouring node IDs over the whole trace
+  uint64_t h = std::min (idA, idB) * 0x9E3779B97F4A7C15ULL + std::max (idA, idB) * 0xC2B2AE3D27D4EB4FULL;
+  h ^= h >> 29;
+  h *= 0xBF58476D1CE4E5B9ULL;
+  h ^= h >> 32;
+  uint32_t offset = h % m_nSamples;
+  m_linkOffsets[link] = offset;
+  return offset;
+}
+
+Ptr<SpectrumValue>
+MmapTraceFadingLossModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                        Ptr<const MobilityModel> a,
+                                                        Ptr<const MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this << *txPsd << a << b);
+  LoadTrace ();
+  uint64_t sample = Simulator::Now ().GetTimeStep () / m_sampleInterval.GetTimeStep ();
+  sample = (sample + GetLinkOffset (a, b)) % m_nSamples;
+  const float *gains = m_gains + sample * m_nFrequencies;
+  const std::vector<uint32_t> &columns = GetColumns (txPsd->GetSpectrumModel ());
+
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
+  Values::iterator vit = rxPsd->ValuesBegin ();
+  for (std::vector<uint32_t>::const_iterator cit = columns.begin (); cit != columns.end (); ++cit, ++vit)
+    {
+      *vit *= gains[*cit];
+    }
+  return rxPsd;
+}
+
+} // namespace ns3
@@ -0,0 +1,135 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MMAP_TRACE_FADING_LOSS_MODEL_H
+#define MMAP_TRACE_FADING_LOSS_MODEL_H
+
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/nstime.h>
+#include <map>
+#include <vector>
+#include <string>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * A frequency-selective fading model driven by pre-generated traces,
+ * which applies to any SpectrumModel, hence to both the LTE and the
+ * Wi-Fi signals sharing a SpectrumChannel.
+ *
+ * The trace is a binary file holding, for each time sample, the linear
+ * fading gain over a uniform frequency grid; it is memory-mapped
+ * read-only, so that all the processes of a simulation campaign using
+ * the same file share a single physical copy. The gain applied to a
+ * band is the one of the grid point containing the center frequency of
+ * the band (clamped to the ends of the grid), at the time sample
+ * containing the current simulation time, shifted by an offset specific
+ * to the link. The offset is derived from the IDs of the two nodes, and
+ * does not depend on the direction of the link, so that different links
+ * see uncorrelated portions of the trace while the results stay
+ * reproducible and no random variate is drawn. The trace wraps around
+ * at its end.
+ *
+ * Trace files are built from the ASCII traces generated for the
+ * TraceFadingLossModel of the LTE module (one line per RB, one value in
+ * dB per sample) with WriteTraceFile ().
+ */
+class MmapTraceFadingLossModel : public SpectrumPropagationLossModel
+{
+public:
+  MmapTraceFadingLossModel ();
+  virtual ~MmapTraceFadingLossModel ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Convert an ASCII trace of the LTE TraceFadingLossModel into a trace
+   * file, which is written atomically (to a temporary file which is then
+   * renamed)
+   *
+   * \param asciiFile the ASCII trace: nFrequencies lines of nSamples
+   * values in dB
+   * \param traceFile the trace file to be written
+   * \param nFrequencies the number of points of the frequency grid
+   * \param nSamples the number of time samples
+   * \param sampleInterval the time between two samples
+   * \param startFrequency the first point of the frequency grid, in Hz
+   * \param frequencyStep the spacing of the frequency grid, in Hz
+   * \return true if the file was written
+   */
+  static bool WriteTraceFile (std::string asciiFile, std::string traceFile,
+                              uint32_t nFrequencies, uint32_t nSamples, Time sampleInterval,
+                              double startFrequency, double frequencyStep);
+
+  /**
+   * \param a the mobility model of one end of the link
+   * \param b the mobility model of the other end of the link
+   * \return the offset of the link, in samples
+   */
+  uint32_t GetLinkOffset (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  // inherited from SpectrumPropagationLossModel
+  virtual Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                           Ptr<const MobilityModel> a,
+                                                           Ptr<const MobilityModel> b) const;
+
+  /// map the trace file, if not done yet
+  void LoadTrace (void) const;
+
+  /// unmap the trace file, if mapped
+  void UnmapTrace (void) const;
+
+  /**
+   * \param model a SpectrumModel
+   * \return the index in the frequency grid of each band of model
+   */
+  const std::vector<uint32_t> & GetColumns (Ptr<const SpectrumModel> model) const;
+
+  std::string m_traceFile; ///< the trace file
+
+  mutable void *m_mapped; ///< start of the mapped trace file, or 0
+  mutable size_t m_mappedLength; ///< length of the mapped trace file
+  mutable const float *m_gains; ///< the gains, one row of m_nFrequencies per sample
+  mutable uint32_t m_nSamples; ///< number of time samples
+  mutable uint32_t m_nFrequencies; ///< number of points of the frequency grid
+  mutable Time m_sampleInterval; ///< time between two samples
+  mutable double m_startFrequency; ///< first point of the frequency grid (Hz)
+  mutable double m_frequencyStep; ///< spacing of the frequency grid (Hz)
+  /// grid index of each band, per SpectrumModel
+  mutable std::map<SpectrumModelUid_t, std::vector<uint32_t> > m_columns;
+  /// link offsets, indexed by the pair of mobility models
+  mutable std::map<std::pair<const MobilityModel *, const MobilityModel *>, uint32_t> m_linkOffsets;
+};
+
+} // namespace ns3
+
+#endif /* MMAP_TRACE_FADING_LOSS_MODEL_H */
@@ -0,0 +1,165 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+#include <ns3/socket.h>
+#include <ns3/socket-factory.h>
+#include <ns3/packet.h>
+#include <ns3/inet-socket-address.h>
+#include <ns3/seq-ts-header.h>
+
+#include "multi-destination-udp-client.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultiDestinationUdpClient");
+
+NS_OBJECT_ENSURE_REGISTERED (MultiDestinationUdpClient);
+
+TypeId
+MultiDestinationUdpClient::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultiDestinationUdpClient")
+    .SetParent<Application> ()
+    .SetGroupName ("LaaWifiCoexistence")
+    .AddConstructor<MultiDestinationUdpClient> ()
+    .AddAttribute ("MaxPackets",
+                   "The maximum number of packets the application will send to each destination",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&MultiDestinationUdpClient::m_count),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Interval",
+                   "The time to wait between packets",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&MultiDestinationUdpClient::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("RemotePort",
+                   "The destination port of the outbound packets",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&MultiDestinationUdpClient::m_port),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("PacketSize",
+                   "Size of packets generated. The minimum packet size is 12 bytes which is the size of the header carrying the sequence number and the time stamp.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&MultiDestinationUdpClient::m_size),
+                   MakeUintegerChecker<uint32_t> (12, 1500))
+  ;
+  return tid;
+}
+
+MultiDestinationUdpClient::MultiDestinationUdpClient ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MultiDestinationUdpClient::~MultiDestinationUdpClient ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultiDestinationUdpClient::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+  m_payload = 0;
+  Application::DoDispose ();
+}
+
+void
+MultiDestinationUdpClient::AddDestination (Ipv4Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_destinations.push_back (address);
+  m_sent.push_back (0);
+}
+
+uint32_t
+MultiDestinationUdpClient::GetNDestinations (void) const
+{
+  return m_destinations.size ();
+}
+
+uint32_t
+MultiDestinationUdpClient::GetNSent (uint32_t i) const
+{
+  NS_ASSERT (i < m_sent.size ());
+  return m_sent[i];
+}
+
+void
+MultiDestinationUdpClient::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_socket == 0)
+    {
+      TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+      m_socket = Socket::CreateSocket (GetNode (), tid);
+      m_socket->Bind ();
+    }
+  m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+  m_payload = Create<Packet> (m_size - (8 + 4)); // 8+4 : the size of the seqTs header
+  m_sendEvent = Simulator::Schedule (Seconds (0.0), &MultiDestinationUdpClient::Send, this);
+}
+
+void
+MultiDestinationUdpClient::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_sendEvent);
+}
+
+void
+MultiDestinationUdpClient::Send (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_sendEvent.IsExpired ());
+  bool more = false;
+  for (uint32_t i = 0; i < m_destinations.size (); ++i)
+    {
+      if (m_sent[i] >= m_count)
+        {
+          continue;
+        }
+      SeqTsHeader seqTs;
+      seqTs.SetSeq (m_sent[i]);
+      Ptr<Packet> p = m_payload->Copy ();
+      p->AddHeader (seqTs);
+      if (m_socket->SendTo (p, 0, InetSocketAddress (m_destinations[i], m_port)) >= 0)
+        {
+          ++m_sent[i];
+          NS_LOG_INFO ("TraceDelay TX " << m_size << " bytes to " << m_destinations[i]
+                       << " Uid: " << p->GetUid () << " Time: " << Simulator::Now ().GetSeconds ());
+        }
+      else
+        {
+          NS_LOG_INFO ("Error while sending " << m_size << " bytes to " << m_destinations[i]);
+        }
+      more = more || m_sent[i] < m_count;
+    }
+  if (more)
+    {
+      m_sendEvent = Simulator::Schedule (m_interval, &MultiDestinationUdpClient::Send, this);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,97 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MULTI_DESTINATION_UDP_CLIENT_H
+#define MULTI_DESTINATION_UDP_CLIENT_H
+
+#include <ns3/application.h>
+#include <ns3/event-id.h>
+#include <ns3/ptr.h>
+#include <ns3/ipv4-address.h>
+#include <ns3/nstime.h>
+#include <vector>
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * A UDP client sending the same constant bit rate stream to several
+ * destinations: equivalent to a UdpClient per destination, all started
+ * at the same time, but with a single timer and a single socket.
+ *
+ * Every Interval, one packet is sent to each destination in the order
+ * in which the destinations were added, which is the order in which
+ * the timers of the UdpClients started together expire.  Each packet
+ * carries a SeqTsHeader with the sequence number of its destination
+ * and the send time, as the packets of UdpClient, so that UdpServer
+ * and FlowMonitor see one flow per destination as before; only the
+ * source port is shared.  The payload is a packet created once and
+ * copied for each transmission.
+ */
+class MultiDestinationUdpClient : public Application
+{
+public:
+  static TypeId GetTypeId (void);
+  MultiDestinationUdpClient ();
+  virtual ~MultiDestinationUdpClient ();
+
+  /**
+   * \param address the address of a destination, to be added before
+   * the application starts
+   */
+  void AddDestination (Ipv4Address address);
+
+  /// \return the number of destinations
+  uint32_t GetNDestinations (void) const;
+
+  /**
+   * \param i the index of a destination
+   * \return the number of packets sent to it
+   */
+  uint32_t GetNSent (uint32_t i) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /// send a packet to each destination and reschedule
+  void Send (void);
+
+  std::vector<Ipv4Address> m_destinations; ///< the destinations
+  std::vector<uint32_t> m_sent; ///< packets sent to each destination
+  uint32_t m_count; ///< maximum number of packets sent to each destination
+  Time m_interval; ///< time between two rounds of packets
+  uint32_t m_size; ///< size of the packets, including the SeqTsHeader
+  uint16_t m_port; ///< destination port
+  Ptr<Socket> m_socket; ///< the socket shared by all the flows
+  Ptr<Packet> m_payload; ///< payload copied into every packet
+  EventId m_sendEvent; ///< the next round of packets
+};
+
+} // namespace ns3
+
+#endif /* MULTI_DESTINATION_UDP_CLIENT_H */
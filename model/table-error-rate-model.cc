@@ -0,0 +1,536 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <ns3/double.h>
+#include <ns3/string.h>
+#include <ns3/nist-error-rate-model.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+#include "table-error-rate-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TableErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TableErrorRateModel);
+
+/// identifies a TableFile, and the version of its layout
+static const char TABLE_FILE_MAGIC[8] = { 'L', 'A', 'A', 'E', 'R', 'T', '2', '\0' };
+
+/// log10 (BER) stored if the BER is null from the first point of the grid
+static const double MIN_LOG10_BER = -300;
+
+/// log10 (BER) below the SNR grid at least, i.e., a BER of 0.5
+static const double BELOW_GRID_LOG10_BER = std::log10 (0.5);
+
+/// key of the frame synchronization table, not used by any WifiMode
+static const uint32_t FRAME_SYNC_TABLE_KEY = 0;
+
+/**
+ * Layout of a TableFile: this header, followed by nTables 64-bit keys
+ * and by nTables tables of nPoints doubles each, in native byte order
+ * (the file is a cache, not meant to be moved across platforms)
+ */
+struct TableFileHeader
+{
+  char magic[8]; ///< TABLE_FILE_MAGIC
+  uint32_t nTables; ///< number of tables
+  uint32_t nPoints; ///< number of points of the SNR grid
+  double minSnrDb; ///< first point of the SNR grid
+  double stepDb; ///< spacing of the SNR grid
+};
+
+/**
+ * \param mode a WifiMode
+ * \return the key of the table of mode: modes with the same
+ * constellation and code rate, e.g., single and dual spatial stream
+ * MCSs, share the same table
+ */
+static uint32_t
+GetTableKey (WifiMode mode)
+{
+  return mode.GetConstellationSize () * 16 + mode.GetCodeRate ();
+}
+
+
+ErrorRateTableSet::ErrorRateTableSet (std::string file, double minSnrDb, double stepDb, uint32_t nPoints)
+  : m_file (file),
+    m_minSnrDb (minSnrDb),
+    m_stepDb (stepDb),
+    m_nPoints (nPoints),
+    m_mapped (0),
+    m_mappedLength (0)
+{
+  NS_LOG_FUNCTION (this << file << minSnrDb << stepDb << nPoints);
+  if (!m_file.empty ())
+    {
+      Load ();
+    }
+}
+
+ErrorRateTableSet::~ErrorRateTableSet ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_mapped != 0)
+    {
+      munmap (m_mapped, m_mappedLength);
+    }
+}
+
+const TableFileHeader *
+ErrorRateTableSet::Map (size_t *length) const
+{
+  NS_LOG_FUNCTION (this << m_file);
+  int fd = open (m_file.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_LOGIC ("table file " << m_file << " not found");
+      return 0;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || st.st_size < static_cast<off_t> (sizeof (TableFileHeader)))
+    {
+      close (fd);
+      NS_LOG_WARN ("ignoring invalid table file " << m_file);
+      return 0;
+    }
+  *length = st.st_size;
+  void *addr = mmap (0, *length, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid after the file is closed
+  close (fd);
+  if (addr == MAP_FAILED)
+    {
+      NS_LOG_WARN ("could not map table file " << m_file);
+      return 0;
+    }
+
+  const TableFileHeader *header = static_cast<const TableFileHeader *> (addr);
+  if (std::memcmp (header->magic, TABLE_FILE_MAGIC, sizeof (TABLE_FILE_MAGIC)) != 0
+      || header->nPoints != m_nPoints
+      || header->minSnrDb != m_minSnrDb
+      || header->stepDb != m_stepDb
+      || *length != sizeof (TableFileHeader) + header->nTables * (sizeof (uint64_t) + m_nPoints * sizeof (double)))
+    {
+      munmap (addr, *length);
+      NS_LOG_WARN ("ignoring table file " << m_file << " built with a different SNR grid or layout");
+      return 0;
+    }
+  return header;
+}
+
+void
+ErrorRateTableSet::Load (void)
+{
+  NS_LOG_FUNCTION (this << m_file);
+  size_t length;
+  const TableFileHeader *header = Map (&length);
+  if (header == 0)
+    {
+      return;
+    }
+  const uint64_t *keys = reinterpret_cast<const uint64_t *> (header + 1);
+  const double *data = reinterpret_cast<const double *> (keys + header->nTables);
+  for (uint32_t i = 0; i < header->nTables; ++i)
+    {
+      m_tables[keys[i]] = data + i * m_nPoints;
+    }
+  m_mapped = const_cast<TableFileHeader *> (header);
+  m_mappedLength = length;
+  NS_LOG_LOGIC ("mapped " << header->nTables << " tables from " << m_file);
+}
+
+void
+ErrorRateTableSet::Merge (void)
+{
+  NS_LOG_FUNCTION (this << m_file);
+  size_t length;
+  const TableFileHeader *header = Map (&length);
+  if (header == 0)
+    {
+      return;
+    }
+  const uint64_t *keys = reinterpret_cast<const uint64_t *> (header + 1);
+  const double *data = reinterpret_cast<const double *> (keys + header->nTables);
+  for (uint32_t i = 0; i < header->nTables; ++i)
+    {
+      if (m_tables.find (keys[i]) == m_tables.end ())
+        {
+          // saved by another process since this set was loaded; copied,
+          // since this mapping is released below
+          std::vector<double> &stored = m_computed[keys[i]];
+          stored.assign (data + i * m_nPoints, data + (i + 1) * m_nPoints);
+          m_tables[keys[i]] = &stored[0];
+        }
+    }
+  munmap (const_cast<TableFileHeader *> (header), length);
+}
+
+void
+ErrorRateTableSet::Save (void)
+{
+  NS_LOG_FUNCTION (this << m_file);
+  // the processes saving to the same file are serialized, so that each
+  // one merges the tables the others have saved since it loaded the
+  // file, instead of replacing them with its own
+  std::string lockFile = m_file + ".lock";
+  int lockFd = open (lockFile.c_str (), O_RDWR | O_CREAT, 0644);
+  if (lockFd < 0 || flock (lockFd, LOCK_EX) != 0)
+    {
+      NS_LOG_WARN ("could not lock " << lockFile << ", tables saved concurrently may be lost");
+    }
+  Merge ();
+
+  std::ostringstream tmpFile;
+  tmpFile << m_file << ".tmp." << getpid ();
+
+  TableFileHeader header;
+  std::memcpy (header.magic, TABLE_FILE_MAGIC, sizeof (TABLE_FILE_MAGIC));
+  header.nTables = m_tables.size ();
+  header.nPoints = m_nPoints;
+  header.minSnrDb = m_minSnrDb;
+  header.stepDb = m_stepDb;
+
+  std::ofstream out (tmpFile.str ().c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  for (TableMap::const_iterator it = m_tables.begin (); it != m_tables.end (); ++it)
+    {
+      uint64_t key = it->first;
+      out.write (reinterpret_cast<const char *> (&key), sizeof (key));
+    }
+  for (TableMap::const_iterator it = m_tables.begin (); it != m_tables.end (); ++it)
+    {
+      out.write (reinterpret_cast<const char *> (it->second), m_nPoints * sizeof (double));
+    }
+  out.close ();
+
+  // readers either see the old file or the complete new one
+  if (!out || std::rename (tmpFile.str ().c_str (), m_file.c_str ()) != 0)
+    {
+      NS_LOG_WARN ("could not save table file " << m_file);
+      std::remove (tmpFile.str ().c_str ());
+    }
+  if (lockFd >= 0)
+    {
+      // also releases the lock
+      close (lockFd);
+    }
+}
+
+const double *
+ErrorRateTableSet::Find (uint32_t key) const
+{
+  TableMap::const_iterator it = m_tables.find (key);
+  return (it == m_tables.end ()) ? 0 : it->second;
+}
+
+const double *
+ErrorRateTableSet::Add (uint32_t key, const std::vector<double> &table)
+{
+  NS_LOG_FUNCTION (this << key);
+  NS_ASSERT (table.size () == m_nPoints);
+  std::vector<double> &stored = m_computed[key];
+  stored = table;
+  m_tables[key] = &stored[0];
+  if (!m_file.empty ())
+    {
+      Save ();
+    }
+  return &stored[0];
+}
+
+
+/**
+ * \return the table sets of this process, indexed by file, SNR grid
+ * and reference model type
+ */
+static std::map<std::string, Ptr<ErrorRateTableSet> > &
+GetTableSets (void)
+{
+  static std::map<std::string, Ptr<ErrorRateTableSet> > tableSets;
+  return tableSets;
+}
+
+
+TableErrorRateModel::TableErrorRateModel ()
+  : m_frameSyncTable (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_referenceModel = CreateObject<NistErrorRateModel> ();
+}
+
+TableErrorRateModel::~TableErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+TableErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TableErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("LaaWifiCoexistence")
+    .AddConstructor<TableErrorRateModel> ()
+    .AddAttribute ("TableFile",
+                   "File the tables are memory-mapped from, and saved to when "
+                   "new tables are computed. If empty, the tables are computed "
+                   "by each process and kept in memory.",
+                   StringValue (""),
+                   MakeStringAccessor (&TableErrorRateModel::m_tableFile),
+                   MakeStringChecker ())
+    .AddAttribute ("MinSnrDb",
+                   "First point of the SNR grid (dB)",
+                   DoubleValue (-5.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnrDb",
+                   "Last point of the SNR grid (dB)",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("StepDb",
+                   "Spacing of the SNR grid (dB)",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_stepDb),
+                   MakeDoubleChecker<double> (1e-6))
+  ;
+  return tid;
+}
+
+void
+TableErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_referenceModel = 0;
+  m_tableSet = 0;
+  m_frameSyncTable = 0;
+  ErrorRateModel::DoDispose ();
+}
+
+void
+TableErrorRateModel::SetReferenceModel (Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_referenceModel = model;
+  // tables built with the previous model are no longer valid
+  m_tableSet = 0;
+  m_frameSyncTable = 0;
+}
+
+uint32_t
+TableErrorRateModel::GetNPoints (void) const
+{
+  NS_ASSERT (m_maxSnrDb > m_minSnrDb);
+  return static_cast<uint32_t> (std::floor ((m_maxSnrDb - m_minSnrDb) / m_stepDb + 0.5)) + 1;
+}
+
+double
+TableErrorRateModel::GetGridPosition (double snr) const
+{
+  return (10 * std::log10 (snr) - m_minSnrDb) / m_stepDb;
+}
+
+Ptr<ErrorRateTableSet>
+TableErrorRateModel::GetTableSet (void) const
+{
+  if (m_tableSet == 0)
+    {
+      uint32_t nPoints = GetNPoints ();
+      std::ostringstream id;
+      id << m_tableFile << "|" << m_referenceModel->GetInstanceTypeId ().GetName ()
+         << "|" << m_minSnrDb << "|" << m_stepDb << "|" << nPoints;
+      Ptr<ErrorRateTableSet> &tableSet = GetTableSets ()[id.str ()];
+      // a set no longer used by any model is reloaded, to pick up the
+      // tables saved to the file by other processes in the meantime
+      if (tableSet == 0 || tableSet->GetReferenceCount () == 1)
+        {
+          tableSet = Create<ErrorRateTableSet> (m_tableFile, m_minSnrDb, m_stepDb, nPoints);
+        }
+      m_tableSet = tableSet;
+    }
+  return m_tableSet;
+}
+
+const double *
+TableErrorRateModel::GetTable (WifiMode mode) const
+{
+  Ptr<ErrorRateTableSet> tableSet = GetTableSet ();
+  uint32_t key = GetTableKey (mode);
+  const double *table = tableSet->Find (key);
+  if (table != 0)
+    {
+      return table;
+    }
+
+  NS_LOG_LOGIC ("computing table for " << mode);
+  uint32_t nPoints = GetNPoints ();
+  std::vector<double> values (nPoints);
+  uint32_t i = 0;
+  for (; i < nPoints; ++i)
+    {
+      double snr = std::pow (10.0, (m_minSnrDb + i * m_stepDb) / 10.0);
+      double ber = 1.0 - m_referenceModel->GetChunkSuccessRate (mode, snr, 1);
+      if (!(ber > 0))
+        {
+          break;
+        }
+      values[i] = std::log10 (ber);
+    }
+  // the BER is only known down to the resolution of the chunk success
+  // rate (about 1e-16), and 1 - CSR rounds to zero beyond it;
+  // interpolating towards a floor would make up the BER in between, so
+  // the table is clamped at the last BER sampled
+  double last = (i > 0) ? values[i - 1] : MIN_LOG10_BER;
+  for (; i < nPoints; ++i)
+    {
+      values[i] = last;
+    }
+  return tableSet->Add (key, values);
+}
+
+double
+TableErrorRateModel::GetBer (WifiMode mode, double snr) const
+{
+  const double *table = GetTable (mode);
+  uint32_t nPoints = GetNPoints ();
+  double x = GetGridPosition (snr);
+  double log10Ber;
+  if (!(x >= 0))
+    {
+      // also covers a null SNR
+      log10Ber = std::max (table[0], BELOW_GRID_LOG10_BER);
+    }
+  else if (x >= nPoints - 1)
+    {
+      log10Ber = table[nPoints - 1];
+    }
+  else
+    {
+      uint32_t i = static_cast<uint32_t> (x);
+      double f = x - i;
+      log10Ber = table[i] + f * (table[i + 1] - table[i]);
+    }
+  return std::pow (10.0, log10Ber);
+}
+
+void
+TableErrorRateModel::SetFrameSyncCurve (const std::vector<double> &sinrDb, const std::vector<double> &errorRate)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (!sinrDb.empty () && sinrDb.size () == errorRate.size (), "invalid frame sync curve");
+  for (uint32_t j = 1; j < sinrDb.size (); ++j)
+    {
+      NS_ASSERT_MSG (sinrDb[j] > sinrDb[j - 1], "the SINRs of the frame sync curve must be increasing");
+    }
+  m_frameSyncSinrDb = sinrDb;
+  m_frameSyncErrorRate = errorRate;
+  m_frameSyncTable = 0;
+}
+
+const double *
+TableErrorRateModel::GetFrameSyncTable (void) const
+{
+  if (m_frameSyncTable != 0)
+    {
+      return m_frameSyncTable;
+    }
+  Ptr<ErrorRateTableSet> tableSet = GetTableSet ();
+  const double *table = tableSet->Find (FRAME_SYNC_TABLE_KEY);
+  if (m_frameSyncSinrDb.empty ())
+    {
+      NS_ABORT_MSG_IF (table == 0, "no frame sync curve set, and none in TableFile \"" << m_tableFile << "\"");
+      m_frameSyncTable = table;
+      return table;
+    }
+
+  // sample the curve, with the error rates of its first and last points
+  // outside of it
+  uint32_t nPoints = GetNPoints ();
+  std::vector<double> values (nPoints);
+  uint32_t j = 0;
+  for (uint32_t i = 0; i < nPoints; ++i)
+    {
+      double snrDb = m_minSnrDb + i * m_stepDb;
+      while (j < m_frameSyncSinrDb.size () && m_frameSyncSinrDb[j] <= snrDb)
+        {
+          ++j;
+        }
+      if (j == 0)
+        {
+          values[i] = m_frameSyncErrorRate.front ();
+        }
+      else if (j == m_frameSyncSinrDb.size ())
+        {
+          values[i] = m_frameSyncErrorRate.back ();
+        }
+      else
+        {
+          double f = (snrDb - m_frameSyncSinrDb[j - 1]) / (m_frameSyncSinrDb[j] - m_frameSyncSinrDb[j - 1]);
+          values[i] = m_frameSyncErrorRate[j - 1] + f * (m_frameSyncErrorRate[j] - m_frameSyncErrorRate[j - 1]);
+        }
+    }
+  // the file is only rewritten if it holds another curve
+  if (table == 0 || !std::equal (values.begin (), values.end (), table))
+    {
+      NS_LOG_LOGIC ("saving the frame sync table");
+      table = tableSet->Add (FRAME_SYNC_TABLE_KEY, values);
+    }
+  m_frameSyncTable = table;
+  return table;
+}
+
+double
+TableErrorRateModel::GetFrameSyncErrorRate (double sinr) const
+{
+  NS_LOG_FUNCTION (this << sinr);
+  const double *table = GetFrameSyncTable ();
+  uint32_t nPoints = GetNPoints ();
+  double x = GetGridPosition (sinr);
+  if (!(x > 0))
+    {
+      return table[0];
+    }
+  if (x >= nPoints - 1)
+    {
+      return table[nPoints - 1];
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double f = x - i;
+  return table[i] + f * (table[i + 1] - table[i]);
+}
+
+double
+TableErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << snr << nbits);
+  return std::pow (1.0 - GetBer (mode, snr), static_cast<double> (nbits));
+}
+
+} // namespace ns3
@@ -0,0 +1,221 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABLE_ERROR_RATE_MODEL_H
+#define TABLE_ERROR_RATE_MODEL_H
+
+#include <ns3/error-rate-model.h>
+#include <ns3/wifi-mode.h>
+#include <ns3/ptr.h>
+#include <ns3/simple-ref-count.h>
+#include <map>
+#include <vector>
+#include <string>
+
+namespace ns3 {
+
+struct TableFileHeader;
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * A set of tables of values (e.g., log10 (BER)) over a uniform SNR
+ * grid, indexed by an integer key, optionally backed by a file.
+ *
+ * If a file is given, it is memory-mapped read-only, so that all the
+ * processes of a simulation campaign share the same physical pages.
+ * Each table added afterwards is kept in memory and the file is
+ * rewritten atomically (write to a temporary file and rename), so that
+ * concurrent processes always see a complete file. The rewrites are
+ * serialized with a lock on a companion file (the name of the file
+ * followed by ".lock"), and each one merges the tables saved by other
+ * processes in the meantime, so that none is lost. A file built with a
+ * different SNR grid is ignored and eventually replaced.
+ */
+class ErrorRateTableSet : public SimpleRefCount<ErrorRateTableSet>
+{
+public:
+  /**
+   * \param file the file backing the tables, empty if none
+   * \param minSnrDb the first point of the SNR grid
+   * \param stepDb the spacing of the SNR grid
+   * \param nPoints the number of points of the SNR grid
+   */
+  ErrorRateTableSet (std::string file, double minSnrDb, double stepDb, uint32_t nPoints);
+  ~ErrorRateTableSet ();
+
+  /**
+   * \param key the key of a table
+   * \return the table, or 0 if there is none with this key
+   */
+  const double * Find (uint32_t key) const;
+
+  /**
+   * Add a table, and save all the tables to the file, if any
+   *
+   * \param key the key of the table
+   * \param table the table, with one value per point of the SNR grid
+   * \return the stored table
+   */
+  const double * Add (uint32_t key, const std::vector<double> &table);
+
+private:
+  /**
+   * \param length set to the length of the mapping
+   * \return the start of the file mapped read-only, or 0 if it does not
+   * exist or does not match the SNR grid
+   */
+  const TableFileHeader * Map (size_t *length) const;
+  /// map the file, if it exists and matches the SNR grid
+  void Load (void);
+  /// copy the tables of the file not known yet, if it matches the SNR grid
+  void Merge (void);
+  /// atomically replace the file with all the tables known and those of the file
+  void Save (void);
+
+  /// tables indexed by key, either mapped or in m_computed
+  typedef std::map<uint32_t, const double *> TableMap;
+
+  std::string m_file; ///< the file backing the tables, empty if none
+  double m_minSnrDb; ///< first point of the SNR grid
+  double m_stepDb; ///< spacing of the SNR grid
+  uint32_t m_nPoints; ///< number of points of the SNR grid
+  TableMap m_tables; ///< all the tables
+  std::map<uint32_t, std::vector<double> > m_computed; ///< tables added by this process
+  void *m_mapped; ///< start of the mapped file, or 0
+  size_t m_mappedLength; ///< length of the mapped file
+};
+
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * An ErrorRateModel which looks up precomputed bit error rates instead
+ * of evaluating analytic formulas for every chunk.
+ *
+ * For each combination of constellation size and code rate (i.e., for
+ * HT MCS 0-7, to which the dual spatial stream MCS 8-15 are mapped),
+ * the bit error rate of a reference ErrorRateModel (NistErrorRateModel
+ * by default) is sampled on a uniform SNR grid, in dB, and stored as
+ * log10 (BER); a lookup interpolates linearly between the two nearest
+ * grid points, and the chunk success rate is (1 - BER)^nbits, as done
+ * by NistErrorRateModel and FreqSelectiveErrorRateModel. SNRs above
+ * the grid are clamped to its end; below the grid, the BER is the one
+ * of its first point, but not lower than 0.5, since nothing is known of
+ * the reference model there. The BER is obtained as 1 - CSR of one
+ * bit, which rounds to zero below about 1e-16: from the first grid
+ * point where it does, the table holds the last BER sampled.
+ *
+ * The model also holds the frame synchronization error rate as a
+ * function of the SINR, used by the CCA-CS logic of the Wi-Fi PHY (the
+ * AWGN or Channel Model D curves of the UW link simulator), sampled on
+ * the same grid from the points given with SetFrameSyncCurve, with the
+ * linear interpolation applied by the Wi-Fi PHY between them.
+ *
+ * The tables are computed on first use and shared by all the instances
+ * of the process with the same TableFile, SNR grid and reference model
+ * type; if TableFile is set, they are also memory-mapped from and saved
+ * to that file (see ErrorRateTableSet). The file does not record the
+ * attributes of the reference model: use a different file for each
+ * reference model configuration. The frame synchronization table is
+ * stored in the same file; if it differs from the curve set, it is
+ * replaced.
+ */
+class TableErrorRateModel : public ErrorRateModel
+{
+public:
+  TableErrorRateModel ();
+  virtual ~TableErrorRateModel ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  // inherited from ErrorRateModel
+  virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
+  /**
+   * \param model the ErrorRateModel sampled to build the tables
+   */
+  void SetReferenceModel (Ptr<ErrorRateModel> model);
+
+  /**
+   * \param mode a WifiMode
+   * \param snr the SNR (linear)
+   * \return the interpolated bit error rate
+   */
+  double GetBer (WifiMode mode, double snr) const;
+
+  /**
+   * Set the frame synchronization error rate curve
+   *
+   * \param sinrDb the SINRs of the points of the curve (dB), increasing
+   * \param errorRate the frame synchronization error rate at each point
+   */
+  void SetFrameSyncCurve (const std::vector<double> &sinrDb, const std::vector<double> &errorRate);
+
+  /**
+   * \param sinr the average SINR (linear) during the PLCP preamble
+   * \return the interpolated frame synchronization error rate, from the
+   * curve set with SetFrameSyncCurve or, if none, from TableFile
+   */
+  double GetFrameSyncErrorRate (double sinr) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \param mode a WifiMode
+   * \return the table of log10 (BER) for the constellation and code
+   * rate of mode, built if needed
+   */
+  const double * GetTable (WifiMode mode) const;
+
+  /// \return the tables, with those of TableFile if any
+  Ptr<ErrorRateTableSet> GetTableSet (void) const;
+
+  /// \return the frame synchronization error rate table, built if needed
+  const double * GetFrameSyncTable (void) const;
+
+  /// \return the number of points of the SNR grid
+  uint32_t GetNPoints (void) const;
+
+  /**
+   * \param snr an SNR (linear)
+   * \return the position of snr in the SNR grid, in points from its start
+   */
+  double GetGridPosition (double snr) const;
+
+  Ptr<ErrorRateModel> m_referenceModel; ///< the model sampled to build the tables
+  std::string m_tableFile; ///< file holding the tables, empty if none
+  double m_minSnrDb; ///< first point of the SNR grid
+  double m_maxSnrDb; ///< last point of the SNR grid
+  double m_stepDb; ///< spacing of the SNR grid
+  mutable Ptr<ErrorRateTableSet> m_tableSet; ///< the tables, obtained on first use
+  std::vector<double> m_frameSyncSinrDb; ///< SINRs of the frame synchronization curve
+  std::vector<double> m_frameSyncErrorRate; ///< error rates of the frame synchronization curve
+  mutable const double *m_frameSyncTable; ///< the frame synchronization table, once built
+};
+
+} // namespace ns3
+
+#endif /* TABLE_ERROR_RATE_MODEL_H */
@@ -0,0 +1,277 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <ns3/log.h>
+#include <ns3/double.h>
+#include <ns3/wifi-phy.h>
+#include <algorithm>
+#include <limits>
+
+#include "threshold-ideal-wifi-manager.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ThresholdIdealWifiManager");
+
+/**
+ * A station, with the sorted thresholds of its supported modes and the
+ * cached data mode.
+ */
+struct ThresholdIdealWifiRemoteStation : public WifiRemoteStation
+{
+  double m_lastSnr; ///< SNR of the last data frame acknowledged
+  uint32_t m_nSupported; ///< number of supported modes when m_thresholds was built
+  std::vector<std::pair<double, WifiMode> > m_thresholds; ///< thresholds of the supported modes, in increasing order
+  WifiMode m_dataMode; ///< the data mode for SNRs in (m_lowSnr, m_highSnr]
+  double m_lowSnr; ///< lower end of the SNR range of m_dataMode (excluded)
+  double m_highSnr; ///< higher end of the SNR range of m_dataMode (included)
+};
+
+/// order thresholds by SNR only, so that stable_sort keeps ties in the order of the supported modes
+static bool
+CompareThresholds (const std::pair<double, WifiMode> &a, const std::pair<double, WifiMode> &b)
+{
+  return a.first < b.first;
+}
+
+/// order a threshold and an SNR
+static bool
+ThresholdLessThanSnr (const std::pair<double, WifiMode> &threshold, double snr)
+{
+  return threshold.first < snr;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (ThresholdIdealWifiManager);
+
+TypeId
+ThresholdIdealWifiManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ThresholdIdealWifiManager")
+    .SetParent<WifiRemoteStationManager> ()
+    .SetGroupName ("LaaWifiCoexistence")
+    .AddConstructor<ThresholdIdealWifiManager> ()
+    .AddAttribute ("BerThreshold",
+                   "The maximum Bit Error Rate acceptable at any transmission mode",
+                   DoubleValue (10e-6),
+                   MakeDoubleAccessor (&ThresholdIdealWifiManager::m_ber),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+ThresholdIdealWifiManager::ThresholdIdealWifiManager ()
+  : m_nDataDecisions (0),
+    m_nSearches (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ThresholdIdealWifiManager::~ThresholdIdealWifiManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ThresholdIdealWifiManager::SetupPhy (Ptr<WifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  m_thresholds.clear ();
+  uint32_t nModes = phy->GetNModes ();
+  for (uint32_t i = 0; i < nModes; i++)
+    {
+      WifiMode mode = phy->GetMode (i);
+      m_thresholds.push_back (std::make_pair (phy->CalculateSnr (mode, m_ber), mode));
+    }
+  WifiRemoteStationManager::SetupPhy (phy);
+}
+
+double
+ThresholdIdealWifiManager::GetSnrThreshold (WifiMode mode) const
+{
+  for (std::vector<std::pair<double, WifiMode> >::const_iterator i = m_thresholds.begin (); i != m_thresholds.end (); i++)
+    {
+      if (mode == i->second)
+        {
+          return i->first;
+        }
+    }
+  NS_ASSERT (false);
+  return 0.0;
+}
+
+WifiRemoteStation *
+ThresholdIdealWifiManager::DoCreateStation (void) const
+{
+  ThresholdIdealWifiRemoteStation *station = new ThresholdIdealWifiRemoteStation ();
+  station->m_lastSnr = 0.0;
+  station->m_nSupported = 0;
+  station->m_lowSnr = std::numeric_limits<double>::infinity ();
+  station->m_highSnr = -std::numeric_limits<double>::infinity ();
+  return station;
+}
+
+void
+ThresholdIdealWifiManager::BuildStationThresholds (WifiRemoteStation *st)
+{
+  ThresholdIdealWifiRemoteStation *station = (ThresholdIdealWifiRemoteStation *)st;
+  station->m_nSupported = GetNSupported (station);
+  station->m_thresholds.clear ();
+  for (uint32_t i = 0; i < station->m_nSupported; i++)
+    {
+      WifiMode mode = GetSupported (station, i);
+      double threshold = GetSnrThreshold (mode);
+      // IdealWifiManager never selects a mode with a threshold not above 0
+      if (threshold > 0.0)
+        {
+          station->m_thresholds.push_back (std::make_pair (threshold, mode));
+        }
+    }
+  std::stable_sort (station->m_thresholds.begin (), station->m_thresholds.end (), &CompareThresholds);
+  // empty range, forcing a search
+  station->m_lowSnr = std::numeric_limits<double>::infinity ();
+  station->m_highSnr = -std::numeric_limits<double>::infinity ();
+}
+
+void
+ThresholdIdealWifiManager::DoReportRxOk (WifiRemoteStation *station,
+                                         double rxSnr, WifiMode txMode)
+{
+}
+
+void
+ThresholdIdealWifiManager::DoReportRtsFailed (WifiRemoteStation *station)
+{
+}
+
+void
+ThresholdIdealWifiManager::DoReportDataFailed (WifiRemoteStation *station)
+{
+}
+
+void
+ThresholdIdealWifiManager::DoReportRtsOk (WifiRemoteStation *st,
+                                          double ctsSnr, WifiMode ctsMode, double rtsSnr)
+{
+  ThresholdIdealWifiRemoteStation *station = (ThresholdIdealWifiRemoteStation *)st;
+  station->m_lastSnr = rtsSnr;
+}
+
+void
+ThresholdIdealWifiManager::DoReportDataOk (WifiRemoteStation *st,
+                                           double ackSnr, WifiMode ackMode, double dataSnr)
+{
+  ThresholdIdealWifiRemoteStation *station = (ThresholdIdealWifiRemoteStation *)st;
+  station->m_lastSnr = dataSnr;
+}
+
+void
+ThresholdIdealWifiManager::DoReportFinalRtsFailed (WifiRemoteStation *station)
+{
+}
+
+void
+ThresholdIdealWifiManager::DoReportFinalDataFailed (WifiRemoteStation *station)
+{
+}
+
+WifiTxVector
+ThresholdIdealWifiManager::DoGetDataTxVector (WifiRemoteStation *st, uint32_t size)
+{
+  ThresholdIdealWifiRemoteStation *station = (ThresholdIdealWifiRemoteStation *)st;
+  ++m_nDataDecisions;
+  // the supported modes are only added, or reset when the station
+  // associates again, so a change is detected by their number
+  if (station->m_nSupported != GetNSupported (station))
+    {
+      BuildStationThresholds (station);
+    }
+  double snr = station->m_lastSnr;
+  if (!(snr > station->m_lowSnr && snr <= station->m_highSnr))
+    {
+      ++m_nSearches;
+      // the first mode whose threshold is not below the SNR, preceded
+      // by the mode to be used
+      std::vector<std::pair<double, WifiMode> >::const_iterator next =
+        std::lower_bound (station->m_thresholds.begin (), station->m_thresholds.end (), snr, &ThresholdLessThanSnr);
+      station->m_highSnr = (next == station->m_thresholds.end ()) ? std::numeric_limits<double>::infinity () : next->first;
+      if (next == station->m_thresholds.begin ())
+        {
+          station->m_dataMode = GetDefaultMode ();
+          station->m_lowSnr = -std::numeric_limits<double>::infinity ();
+        }
+      else
+        {
+          // among modes with the same threshold, IdealWifiManager keeps
+          // the first supported one
+          std::vector<std::pair<double, WifiMode> >::const_iterator selected = next - 1;
+          while (selected != station->m_thresholds.begin () && (selected - 1)->first == selected->first)
+            {
+              --selected;
+            }
+          station->m_dataMode = selected->second;
+          station->m_lowSnr = selected->first;
+        }
+      NS_LOG_DEBUG ("SNR " << snr << ": mode " << station->m_dataMode << " for SNRs in ("
+                           << station->m_lowSnr << ", " << station->m_highSnr << "]");
+    }
+  return WifiTxVector (station->m_dataMode, GetDefaultTxPowerLevel (), GetLongRetryCount (station), GetShortGuardInterval (station), std::min (GetNumberOfReceiveAntennas (station), GetNumberOfTransmitAntennas ()), GetNess (station), GetStbc (station));
+}
+
+WifiTxVector
+ThresholdIdealWifiManager::DoGetRtsTxVector (WifiRemoteStation *st)
+{
+  ThresholdIdealWifiRemoteStation *station = (ThresholdIdealWifiRemoteStation *)st;
+  // the basic modes are few and RTS frames are rare, so they are
+  // scanned as in IdealWifiManager
+  double maxThreshold = 0.0;
+  WifiMode maxMode = GetDefaultMode ();
+  for (uint32_t i = 0; i < GetNBasicModes (); i++)
+    {
+      WifiMode mode = GetBasicMode (i);
+      double threshold = GetSnrThreshold (mode);
+      if (threshold > maxThreshold
+          && threshold < station->m_lastSnr)
+        {
+          maxThreshold = threshold;
+          maxMode = mode;
+        }
+    }
+  return WifiTxVector (maxMode, GetDefaultTxPowerLevel (), GetShortRetryCount (station), GetShortGuardInterval (station), std::min (GetNumberOfReceiveAntennas (station), GetNumberOfTransmitAntennas ()), GetNess (station), GetStbc (station));
+}
+
+bool
+ThresholdIdealWifiManager::IsLowLatency (void) const
+{
+  return true;
+}
+
+uint64_t
+ThresholdIdealWifiManager::GetNDataDecisions (void) const
+{
+  return m_nDataDecisions;
+}
+
+uint64_t
+ThresholdIdealWifiManager::GetNSearches (void) const
+{
+  return m_nSearches;
+}
+
+} // namespace ns3
@@ -0,0 +1,100 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef THRESHOLD_IDEAL_WIFI_MANAGER_H
+#define THRESHOLD_IDEAL_WIFI_MANAGER_H
+
+#include <ns3/wifi-remote-station-manager.h>
+#include <ns3/wifi-mode.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * The same rate control as IdealWifiManager, with the search of the
+ * data mode replaced by a table lookup.
+ *
+ * IdealWifiManager computes, for each mode of the PHY, the minimum SNR
+ * for which the BER is below BerThreshold; for each data frame it then
+ * scans all the modes supported by the receiver for the one with the
+ * highest threshold below the SNR of the last data frame acknowledged.
+ * Here each station keeps the thresholds of its supported modes sorted,
+ * so that the mode is found with a binary search, and caches the mode
+ * together with the range of SNRs over which it does not change (from
+ * its threshold to the next one); the search is done only when the SNR
+ * leaves that range or the supported modes change, and the choice is
+ * always the same as that of IdealWifiManager.
+ */
+class ThresholdIdealWifiManager : public WifiRemoteStationManager
+{
+public:
+  static TypeId GetTypeId (void);
+  ThresholdIdealWifiManager ();
+  virtual ~ThresholdIdealWifiManager ();
+
+  virtual void SetupPhy (Ptr<WifiPhy> phy);
+
+  /// \return the number of data modes selected
+  uint64_t GetNDataDecisions (void) const;
+
+  /// \return the number of data mode selections that needed a search
+  uint64_t GetNSearches (void) const;
+
+private:
+  // overriden from base class
+  virtual WifiRemoteStation* DoCreateStation (void) const;
+  virtual void DoReportRxOk (WifiRemoteStation *station,
+                             double rxSnr, WifiMode txMode);
+  virtual void DoReportRtsFailed (WifiRemoteStation *station);
+  virtual void DoReportDataFailed (WifiRemoteStation *station);
+  virtual void DoReportRtsOk (WifiRemoteStation *station,
+                              double ctsSnr, WifiMode ctsMode, double rtsSnr);
+  virtual void DoReportDataOk (WifiRemoteStation *station,
+                               double ackSnr, WifiMode ackMode, double dataSnr);
+  virtual void DoReportFinalRtsFailed (WifiRemoteStation *station);
+  virtual void DoReportFinalDataFailed (WifiRemoteStation *station);
+  virtual WifiTxVector DoGetDataTxVector (WifiRemoteStation *station, uint32_t size);
+  virtual WifiTxVector DoGetRtsTxVector (WifiRemoteStation *station);
+  virtual bool IsLowLatency (void) const;
+
+  /**
+   * \param mode a mode of the PHY
+   * \return its SNR threshold
+   */
+  double GetSnrThreshold (WifiMode mode) const;
+
+  /**
+   * Sort the thresholds of the modes supported by a station
+   *
+   * \param station the station
+   */
+  void BuildStationThresholds (WifiRemoteStation *station);
+
+  double m_ber; ///< maximum BER of the selected modes
+  std::vector<std::pair<double, WifiMode> > m_thresholds; ///< SNR threshold of each mode of the PHY, in the order of the PHY
+  uint64_t m_nDataDecisions; ///< number of data modes selected
+  uint64_t m_nSearches; ///< number of binary searches
+};
+
+} // namespace ns3
+
+#endif /* THRESHOLD_IDEAL_WIFI_MANAGER_H */
@@ -0,0 +1,275 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <ns3/log.h>
+#include <ns3/assert.h>
+#include <algorithm>
+
+#include "timing-wheel-scheduler.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimingWheelScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (TimingWheelScheduler);
+
+/**
+ * Order of the events in the heap of the current slot; the heap
+ * algorithms of the STL keep the largest element at the front, hence
+ * the reversed comparison
+ */
+struct EventLater
+{
+  /**
+   * \param a an event
+   * \param b an event
+   * \return true if a is executed after b
+   */
+  bool operator() (const Scheduler::Event &a, const Scheduler::Event &b) const
+  {
+    if (a.key.m_ts != b.key.m_ts)
+      {
+        return a.key.m_ts > b.key.m_ts;
+      }
+    return a.key.m_uid > b.key.m_uid;
+  }
+};
+
+TypeId
+TimingWheelScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimingWheelScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("LaaWifiCoexistence")
+    .AddConstructor<TimingWheelScheduler> ()
+    .AddAttribute ("SlotWidth",
+                   "The width of the slots of the first level of the wheel, "
+                   "rounded down to a power of two time steps.",
+                   TimeValue (NanoSeconds (16384)),
+                   MakeTimeAccessor (&TimingWheelScheduler::SetSlotWidth,
+                                     &TimingWheelScheduler::GetSlotWidth),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+TimingWheelScheduler::TimingWheelScheduler ()
+  : m_cursor (0),
+    m_currentEnd (1),
+    m_slotBits (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t level = 0; level < N_LEVELS; ++level)
+    {
+      m_levelSize[level] = 0;
+    }
+}
+
+TimingWheelScheduler::~TimingWheelScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TimingWheelScheduler::SetSlotWidth (Time width)
+{
+  NS_LOG_FUNCTION (this << width);
+  NS_ASSERT_MSG (m_size == 0, "the slot width cannot be changed while events are queued");
+  int64_t steps = width.GetTimeStep ();
+  m_slotBits = 0;
+  // the shifts of the highest level have to fit in 64 bits
+  while ((steps >> (m_slotBits + 1)) > 0 && m_slotBits < 31)
+    {
+      ++m_slotBits;
+    }
+  m_cursor = 0;
+  m_currentEnd = static_cast<uint64_t> (1) << m_slotBits;
+}
+
+Time
+TimingWheelScheduler::GetSlotWidth (void) const
+{
+  return TimeStep (static_cast<uint64_t> (1) << m_slotBits);
+}
+
+TimingWheelScheduler::Bucket &
+TimingWheelScheduler::FindBucket (uint64_t ts, uint32_t &level)
+{
+  NS_ASSERT (ts >= m_currentEnd);
+  for (level = 0; level < N_LEVELS; ++level)
+    {
+      uint32_t shift = m_slotBits + LEVEL_BITS * level;
+      // the slots of a level only cover the current revolution of the
+      // level above
+      if ((ts >> (shift + LEVEL_BITS)) == (m_cursor >> (shift + LEVEL_BITS)))
+        {
+          return m_wheel[level][(ts >> shift) & (N_SLOTS - 1)];
+        }
+    }
+  return m_overflow;
+}
+
+void
+TimingWheelScheduler::Place (const Event &ev)
+{
+  if (ev.key.m_ts < m_currentEnd)
+    {
+      m_current.push_back (ev);
+      std::push_heap (m_current.begin (), m_current.end (), EventLater ());
+    }
+  else
+    {
+      uint32_t level;
+      FindBucket (ev.key.m_ts, level).push_back (ev);
+      if (level < N_LEVELS)
+        {
+          ++m_levelSize[level];
+        }
+    }
+}
+
+void
+TimingWheelScheduler::Advance (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_current.empty () && m_size > 0)
+    {
+      Bucket bucket;
+      bool found = false;
+      for (uint32_t level = 0; level < N_LEVELS && !found; ++level)
+        {
+          if (m_levelSize[level] == 0)
+            {
+              continue;
+            }
+          uint32_t shift = m_slotBits + LEVEL_BITS * level;
+          uint32_t index = (m_cursor >> shift) & (N_SLOTS - 1);
+          // the slots up to the current one are empty, since all the
+          // events in the wheel are after the current slot
+          for (uint32_t j = index + 1; j < N_SLOTS; ++j)
+            {
+              if (!m_wheel[level][j].empty ())
+                {
+                  uint64_t revolution = (m_cursor >> (shift + LEVEL_BITS)) << (shift + LEVEL_BITS);
+                  m_cursor = revolution + (static_cast<uint64_t> (j) << shift);
+                  bucket.swap (m_wheel[level][j]);
+                  m_levelSize[level] -= bucket.size ();
+                  found = true;
+                  break;
+                }
+            }
+          NS_ASSERT (found);
+        }
+      if (!found)
+        {
+          // the wheel is empty: restart it at the first event of the
+          // overflow list
+          NS_ASSERT (!m_overflow.empty ());
+          uint64_t first = m_overflow.front ().key.m_ts;
+          for (Bucket::const_iterator it = m_overflow.begin (); it != m_overflow.end (); ++it)
+            {
+              first = std::min (first, it->key.m_ts);
+            }
+          m_cursor = (first >> m_slotBits) << m_slotBits;
+          bucket.swap (m_overflow);
+        }
+      m_currentEnd = m_cursor + (static_cast<uint64_t> (1) << m_slotBits);
+      NS_LOG_LOGIC ("cursor moved to " << m_cursor << ", redistributing " << bucket.size () << " events");
+      for (Bucket::const_iterator it = bucket.begin (); it != bucket.end (); ++it)
+        {
+          Place (*it);
+        }
+    }
+}
+
+void
+TimingWheelScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  ++m_size;
+  Place (ev);
+  if (m_current.empty ())
+    {
+      Advance ();
+    }
+}
+
+bool
+TimingWheelScheduler::IsEmpty (void) const
+{
+  return m_size == 0;
+}
+
+Scheduler::Event
+TimingWheelScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_current.empty ());
+  return m_current.front ();
+}
+
+Scheduler::Event
+TimingWheelScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_current.empty ());
+  std::pop_heap (m_current.begin (), m_current.end (), EventLater ());
+  Event ev = m_current.back ();
+  m_current.pop_back ();
+  --m_size;
+  // keep the next event at the front of the heap, so that PeekNext ()
+  // does not have to modify the wheel
+  Advance ();
+  return ev;
+}
+
+void
+TimingWheelScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint32_t level = N_LEVELS;
+  Bucket &bucket = (ev.key.m_ts < m_currentEnd) ? m_current : FindBucket (ev.key.m_ts, level);
+  Bucket::iterator it = bucket.begin ();
+  while (it != bucket.end () && it->key.m_uid != ev.key.m_uid)
+    {
+      ++it;
+    }
+  NS_ASSERT_MSG (it != bucket.end (), "event " << ev.key.m_uid << " not found");
+  if (&bucket == &m_current)
+    {
+      m_current.erase (it);
+      std::make_heap (m_current.begin (), m_current.end (), EventLater ());
+    }
+  else
+    {
+      // the order of the other slots does not matter
+      *it = bucket.back ();
+      bucket.pop_back ();
+      if (level < N_LEVELS)
+        {
+          --m_levelSize[level];
+        }
+    }
+  --m_size;
+  Advance ();
+}
+
+} // namespace ns3
@@ -0,0 +1,119 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TIMING_WHEEL_SCHEDULER_H
+#define TIMING_WHEEL_SCHEDULER_H
+
+#include <ns3/scheduler.h>
+#include <ns3/nstime.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup laa-wifi-coexistence
+ *
+ * A Scheduler based on a hierarchical timing wheel, meant for event
+ * sets dominated by periodic events (LTE subframes, Wi-Fi beacons,
+ * constant bit rate traffic).
+ *
+ * Time is divided in slots of a fixed width (attribute SlotWidth,
+ * rounded down to a power of two time steps). The wheel has 4 levels
+ * of 256 slots, each slot of a level spanning a whole revolution of
+ * the level below; with the default width of 16.384 us (at nanosecond
+ * resolution), the levels cover about 4 ms, 1 s, 4.5 min and 19 h.
+ * Events further in the future are kept in an unsorted overflow list.
+ * An event is appended to its slot in O(1); when the simulation
+ * reaches a slot of the first level, its events are moved to a binary
+ * heap, from which they are removed in time stamp and UID order like
+ * with any other Scheduler. The slots of the higher levels are
+ * redistributed to the lower levels when the simulation reaches them.
+ *
+ * Events inserted in the slot being executed go directly to the heap,
+ * so that many events with the same time stamp cost O(log n) each,
+ * where n is the number of events in the slot.
+ */
+class TimingWheelScheduler : public Scheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TimingWheelScheduler ();
+  virtual ~TimingWheelScheduler ();
+
+  // inherited from Scheduler
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  /**
+   * \param width the width of the slots of the first level, rounded
+   * down to a power of two time steps
+   */
+  void SetSlotWidth (Time width);
+
+  /// \return the width of the slots of the first level
+  Time GetSlotWidth (void) const;
+
+  /// events of a slot, unsorted except for m_current which is a heap
+  typedef std::vector<Event> Bucket;
+
+  /**
+   * \param ts a time stamp not before the end of the current slot
+   * \param level set to the level of the slot, or N_LEVELS for the overflow list
+   * \return the slot where an event with this time stamp is kept
+   */
+  Bucket & FindBucket (uint64_t ts, uint32_t &level);
+
+  /**
+   * Insert an event into the current heap, or into the wheel if it is
+   * not before the end of the current slot
+   *
+   * \param ev the event
+   */
+  void Place (const Event &ev);
+
+  /// move to the next non-empty slot, until the current heap is not empty
+  void Advance (void);
+
+  static const uint32_t LEVEL_BITS = 8; ///< log2 of the number of slots per level
+  static const uint32_t N_SLOTS = 1 << LEVEL_BITS; ///< number of slots per level
+  static const uint32_t N_LEVELS = 4; ///< number of levels
+
+  Bucket m_current; ///< heap of the events before m_currentEnd
+  Bucket m_wheel[N_LEVELS][N_SLOTS]; ///< the slots of all the levels
+  uint32_t m_levelSize[N_LEVELS]; ///< number of events in each level
+  Bucket m_overflow; ///< events beyond the last level
+  uint64_t m_cursor; ///< start of the current slot of the first level
+  uint64_t m_currentEnd; ///< end of the current slot of the first level
+  uint32_t m_slotBits; ///< log2 of the width of the slots of the first level
+  uint64_t m_size; ///< total number of events
+};
+
+} // namespace ns3
+
+#endif /* TIMING_WHEEL_SCHEDULER_H */
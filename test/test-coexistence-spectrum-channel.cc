@@ -0,0 +1,416 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include <ns3/spectrum-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
+#include <ns3/lte-control-messages.h>
+#include <ns3/wifi-spectrum-signal-parameters.h>
+#include <ns3/wifi-mac-header.h>
+#include <ns3/packet.h>
+#include <ns3/node.h>
+#include <ns3/simple-net-device.h>
+
+#include "test-coexistence-spectrum-channel.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestCoexistenceSpectrumChannel");
+
+
+/**
+ * TestSuite
+ */
+
+CoexistenceSpectrumChannelTestSuite::CoexistenceSpectrumChannelTestSuite ()
+  : TestSuite ("laa-coexistence-spectrum-channel", UNIT)
+{
+  // the LTE PHY starts the data frame 1 ns after the end of the control frame
+  AddTestCase (new CoexistenceCtrlFoldTestCase ("control frame folded, gap of 1 ns", NanoSeconds (1), true), TestCase::QUICK);
+  AddTestCase (new CoexistenceCtrlFoldTestCase ("control frame folded, no gap", Time (0), true), TestCase::QUICK);
+  AddTestCase (new CoexistenceCtrlFoldTestCase ("control frame dropped, gap of 2 us", MicroSeconds (2), false), TestCase::QUICK);
+  AddTestCase (new CoexistenceCtrlWithoutDataTestCase (), TestCase::QUICK);
+  AddTestCase (new CoexistenceMeasuredCellsTestCase (), TestCase::QUICK);
+  AddTestCase (new CoexistenceBeaconCullingTestCase (), TestCase::QUICK);
+}
+
+static CoexistenceSpectrumChannelTestSuite coexistenceSpectrumChannelTestSuite;
+
+
+/**
+ * SpectrumPhy
+ */
+
+CoexistenceTestSpectrumPhy::CoexistenceTestSpectrumPhy (Ptr<const SpectrumModel> model)
+  : m_model (model)
+{
+}
+
+CoexistenceTestSpectrumPhy::~CoexistenceTestSpectrumPhy ()
+{
+}
+
+void
+CoexistenceTestSpectrumPhy::SetDevice (Ptr<NetDevice> d)
+{
+  m_device = d;
+}
+
+Ptr<NetDevice>
+CoexistenceTestSpectrumPhy::GetDevice ()
+{
+  return m_device;
+}
+
+void
+CoexistenceTestSpectrumPhy::SetMobility (Ptr<MobilityModel> m)
+{
+  m_mobility = m;
+}
+
+Ptr<MobilityModel>
+CoexistenceTestSpectrumPhy::GetMobility ()
+{
+  return m_mobility;
+}
+
+void
+CoexistenceTestSpectrumPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+CoexistenceTestSpectrumPhy::GetRxSpectrumModel () const
+{
+  return m_model;
+}
+
+Ptr<AntennaModel>
+CoexistenceTestSpectrumPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+CoexistenceTestSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_received.push_back (params);
+}
+
+const std::vector<Ptr<SpectrumSignalParameters> > &
+CoexistenceTestSpectrumPhy::GetReceivedSignals (void) const
+{
+  return m_received;
+}
+
+
+/**
+ * Control frame folding TestCase
+ */
+
+CoexistenceCtrlFoldTestCase::CoexistenceCtrlFoldTestCase (std::string name, Time gap, bool folded)
+  : TestCase (name),
+    m_gap (gap),
+    m_folded (folded)
+{
+}
+
+CoexistenceCtrlFoldTestCase::~CoexistenceCtrlFoldTestCase ()
+{
+}
+
+void
+CoexistenceCtrlFoldTestCase::DoRun (void)
+{
+  std::vector<double> centerFrequencies;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      centerFrequencies.push_back (5.1725e9 + i * 5e6);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (centerFrequencies);
+
+  Ptr<CoexistenceSpectrumChannel> channel = CreateObject<CoexistenceSpectrumChannel> ();
+  channel->SetAttribute ("ReducedSignalling", BooleanValue (true));
+  Ptr<CoexistenceTestSpectrumPhy> enbPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  Ptr<CoexistenceTestSpectrumPhy> rxPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  channel->AddRx (rxPhy);
+
+  // timing of LteEnbPhy: the control frame lasts DL_CTRL_DURATION and
+  // the data frame starts at DL_CTRL_DELAY_FROM_SUBFRAME_START
+  Ptr<LteSpectrumSignalParametersDlCtrlFrame> ctrl = Create<LteSpectrumSignalParametersDlCtrlFrame> ();
+  ctrl->txPhy = enbPhy;
+  ctrl->psd = Create<SpectrumValue> (model);
+  *(ctrl->psd) = 1e-15;
+  ctrl->duration = NanoSeconds (214286 - 1);
+  ctrl->cellId = 1;
+  ctrl->pss = false;
+  // the DL DCI announces the data frame
+  ctrl->ctrlMsgList.push_back (Create<DlDciLteControlMessage> ());
+
+  Ptr<LteSpectrumSignalParametersDataFrame> data = Create<LteSpectrumSignalParametersDataFrame> ();
+  data->txPhy = enbPhy;
+  data->psd = Create<SpectrumValue> (model);
+  *(data->psd) = 4e-16;
+  Time dataStart = ctrl->duration + m_gap;
+  // the data frame ends within the subframe
+  data->duration = MilliSeconds (1) - dataStart - NanoSeconds (1);
+  data->cellId = 1;
+
+  Simulator::Schedule (Time (0), &CoexistenceSpectrumChannel::StartTx, channel, ctrl);
+  Simulator::Schedule (dataStart, &CoexistenceSpectrumChannel::StartTx, channel, data);
+  Simulator::Run ();
+
+  double ctrlEnergy = Integral (*(ctrl->psd)) * ctrl->duration.GetSeconds ();
+  double dataEnergy = Integral (*(data->psd)) * data->duration.GetSeconds ();
+
+  const std::vector<Ptr<SpectrumSignalParameters> > &received = rxPhy->GetReceivedSignals ();
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNSuppressedDeliveries (), 1, "the control frame was delivered to the non-LTE receiver");
+  NS_TEST_ASSERT_MSG_EQ (received.size (), 1, "wrong number of signals received");
+  NS_TEST_ASSERT_MSG_EQ ((DynamicCast<LteSpectrumSignalParametersDataFrame> (received[0]) != 0), true, "the data frame was not received");
+  NS_TEST_ASSERT_MSG_EQ (received[0]->duration, data->duration, "wrong duration of the data frame");
+
+  double energy = Integral (*(received[0]->psd)) * received[0]->duration.GetSeconds ();
+  double expected = dataEnergy + (m_folded ? ctrlEnergy : 0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (energy, expected, expected * 1e-9, "wrong energy received in the subframe");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Control frame without data frame TestCase
+ */
+
+CoexistenceCtrlWithoutDataTestCase::CoexistenceCtrlWithoutDataTestCase ()
+  : TestCase ("control frame without DL DCI delivered to all receivers")
+{
+}
+
+CoexistenceCtrlWithoutDataTestCase::~CoexistenceCtrlWithoutDataTestCase ()
+{
+}
+
+void
+CoexistenceCtrlWithoutDataTestCase::DoRun (void)
+{
+  std::vector<double> centerFrequencies;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      centerFrequencies.push_back (5.1725e9 + i * 5e6);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (centerFrequencies);
+
+  Ptr<CoexistenceSpectrumChannel> channel = CreateObject<CoexistenceSpectrumChannel> ();
+  channel->SetAttribute ("ReducedSignalling", BooleanValue (true));
+  Ptr<CoexistenceTestSpectrumPhy> enbPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  Ptr<CoexistenceTestSpectrumPhy> rxPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  channel->AddRx (rxPhy);
+
+  // control region of an empty subframe, with an UL DCI only
+  Ptr<LteSpectrumSignalParametersDlCtrlFrame> ctrl = Create<LteSpectrumSignalParametersDlCtrlFrame> ();
+  ctrl->txPhy = enbPhy;
+  ctrl->psd = Create<SpectrumValue> (model);
+  *(ctrl->psd) = 1e-15;
+  ctrl->duration = NanoSeconds (214286 - 1);
+  ctrl->cellId = 1;
+  ctrl->pss = false;
+  ctrl->ctrlMsgList.push_back (Create<UlDciLteControlMessage> ());
+
+  Simulator::Schedule (Time (0), &CoexistenceSpectrumChannel::StartTx, channel, ctrl);
+  Simulator::Run ();
+
+  const std::vector<Ptr<SpectrumSignalParameters> > &received = rxPhy->GetReceivedSignals ();
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNSuppressedDeliveries (), 0, "the control frame was suppressed");
+  NS_TEST_ASSERT_MSG_EQ (received.size (), 1, "wrong number of signals received");
+  NS_TEST_ASSERT_MSG_EQ ((DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (received[0]) != 0), true, "the control frame was not received");
+  NS_TEST_ASSERT_MSG_EQ (received[0]->duration, ctrl->duration, "wrong duration of the control frame");
+
+  double expected = Integral (*(ctrl->psd)) * ctrl->duration.GetSeconds ();
+  double energy = Integral (*(received[0]->psd)) * received[0]->duration.GetSeconds ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (energy, expected, expected * 1e-9, "wrong energy of the control frame");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Measured cells TestCase
+ */
+
+CoexistenceMeasuredCellsTestCase::CoexistenceMeasuredCellsTestCase ()
+  : TestCase ("PSS hidden from the receivers not measuring the cell")
+{
+}
+
+CoexistenceMeasuredCellsTestCase::~CoexistenceMeasuredCellsTestCase ()
+{
+}
+
+void
+CoexistenceMeasuredCellsTestCase::DoRun (void)
+{
+  std::vector<double> centerFrequencies;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      centerFrequencies.push_back (5.1725e9 + i * 5e6);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (centerFrequencies);
+
+  Ptr<CoexistenceSpectrumChannel> channel = CreateObject<CoexistenceSpectrumChannel> ();
+  Ptr<CoexistenceTestSpectrumPhy> enbPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  Ptr<CoexistenceTestSpectrumPhy> prunedPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  Ptr<CoexistenceTestSpectrumPhy> measuringPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  channel->AddRx (prunedPhy);
+  channel->AddRx (measuringPhy);
+  std::set<uint16_t> measuredCells;
+  measuredCells.insert (2);
+  channel->SetMeasuredCells (prunedPhy, measuredCells);
+
+  // the PSS of cell 1, then of cell 2
+  std::vector<Ptr<LteSpectrumSignalParametersDlCtrlFrame> > ctrls;
+  for (uint16_t cellId = 1; cellId <= 2; ++cellId)
+    {
+      Ptr<LteSpectrumSignalParametersDlCtrlFrame> ctrl = Create<LteSpectrumSignalParametersDlCtrlFrame> ();
+      ctrl->txPhy = enbPhy;
+      ctrl->psd = Create<SpectrumValue> (model);
+      *(ctrl->psd) = 1e-15;
+      ctrl->duration = NanoSeconds (214286 - 1);
+      ctrl->cellId = cellId;
+      ctrl->pss = true;
+      Simulator::Schedule (MilliSeconds (cellId - 1), &CoexistenceSpectrumChannel::StartTx, channel, ctrl);
+      ctrls.push_back (ctrl);
+    }
+  Simulator::Run ();
+
+  const std::vector<Ptr<SpectrumSignalParameters> > &pruned = prunedPhy->GetReceivedSignals ();
+  const std::vector<Ptr<SpectrumSignalParameters> > &measured = measuringPhy->GetReceivedSignals ();
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNPrunedMeasurements (), 1, "wrong number of pruned measurements");
+  NS_TEST_ASSERT_MSG_EQ (pruned.size (), 2, "wrong number of signals received by the pruned receiver");
+  NS_TEST_ASSERT_MSG_EQ (measured.size (), 2, "wrong number of signals received by the other receiver");
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      Ptr<LteSpectrumSignalParametersDlCtrlFrame> prunedCtrl = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (pruned[i]);
+      Ptr<LteSpectrumSignalParametersDlCtrlFrame> measuredCtrl = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (measured[i]);
+      NS_TEST_ASSERT_MSG_EQ ((prunedCtrl != 0), true, "the control frame was not received");
+      NS_TEST_ASSERT_MSG_EQ ((measuredCtrl != 0), true, "the control frame was not received");
+      NS_TEST_ASSERT_MSG_EQ (prunedCtrl->cellId, ctrls[i]->cellId, "wrong cell of the control frame");
+      // the frame is still received as interference
+      NS_TEST_ASSERT_MSG_EQ (prunedCtrl->duration, ctrls[i]->duration, "wrong duration of the control frame");
+      NS_TEST_ASSERT_MSG_EQ (measuredCtrl->pss, true, "PSS hidden from a receiver measuring all the cells");
+      NS_TEST_ASSERT_MSG_EQ (ctrls[i]->pss, true, "the transmitted frame has been modified");
+    }
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (pruned[0])->pss, false, "PSS of an unmeasured cell not hidden");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (pruned[1])->pss, true, "PSS of a measured cell hidden");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Beacon culling TestCase
+ */
+
+CoexistenceBeaconCullingTestCase::CoexistenceBeaconCullingTestCase ()
+  : TestCase ("culled beacons are not delivered")
+{
+}
+
+CoexistenceBeaconCullingTestCase::~CoexistenceBeaconCullingTestCase ()
+{
+}
+
+void
+CoexistenceBeaconCullingTestCase::DoRun (void)
+{
+  std::vector<double> centerFrequencies;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      centerFrequencies.push_back (5.1725e9 + i * 5e6);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (centerFrequencies);
+
+  Ptr<CoexistenceSpectrumChannel> channel = CreateObject<CoexistenceSpectrumChannel> ();
+  channel->SetAttribute ("CullBeacons", BooleanValue (true));
+  Ptr<CoexistenceTestSpectrumPhy> apPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  Ptr<CoexistenceTestSpectrumPhy> culledPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  Ptr<CoexistenceTestSpectrumPhy> decodingPhy = CreateObject<CoexistenceTestSpectrumPhy> (model);
+  // the devices registered for culling are looked up from the PHY
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  node->AddDevice (device);
+  culledPhy->SetDevice (device);
+  channel->SetBeaconCulling (device, true);
+  channel->AddRx (culledPhy);
+  channel->AddRx (decodingPhy);
+
+  WifiMacHeader beaconHdr;
+  beaconHdr.SetType (WIFI_MAC_MGT_BEACON);
+  beaconHdr.SetAddr1 (Mac48Address::GetBroadcast ());
+  beaconHdr.SetAddr2 (Mac48Address ("00:00:00:00:00:01"));
+  beaconHdr.SetAddr3 (Mac48Address ("00:00:00:00:00:01"));
+  Ptr<Packet> beacon = Create<Packet> (50);
+  beacon->AddHeader (beaconHdr);
+
+  Ptr<WifiSpectrumSignalParameters> params = Create<WifiSpectrumSignalParameters> ();
+  params->txPhy = apPhy;
+  params->psd = Create<SpectrumValue> (model);
+  *(params->psd) = 1e-16;
+  params->duration = MicroSeconds (300);
+  params->packet = beacon;
+
+  Simulator::Schedule (Time (0), &CoexistenceSpectrumChannel::StartTx, channel, params);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNBeaconDeliveries (), 2, "wrong number of beacon deliveries");
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNCulledBeacons (), 1, "wrong number of culled beacons");
+  NS_TEST_ASSERT_MSG_EQ (culledPhy->GetReceivedSignals ().size (), 0, "beacon received by the culled receiver");
+  NS_TEST_ASSERT_MSG_EQ (decodingPhy->GetReceivedSignals ().size (), 1, "beacon not received by the decoding receiver");
+
+  Ptr<WifiSpectrumSignalParameters> decoded = DynamicCast<WifiSpectrumSignalParameters> (decodingPhy->GetReceivedSignals ()[0]);
+  NS_TEST_ASSERT_MSG_EQ ((decoded != 0), true, "the beacon is not a Wi-Fi signal");
+  WifiMacHeader hdr;
+  decoded->packet->PeekHeader (hdr);
+  NS_TEST_ASSERT_MSG_EQ (hdr.IsBeacon (), true, "the received frame is not a beacon");
+  NS_TEST_ASSERT_MSG_EQ (hdr.GetAddr1 ().IsBroadcast (), true, "the beacon has been modified");
+
+  // other broadcast frames are delivered to all the receivers
+  WifiMacHeader dataHdr;
+  dataHdr.SetType (WIFI_MAC_DATA);
+  dataHdr.SetAddr1 (Mac48Address::GetBroadcast ());
+  dataHdr.SetAddr2 (Mac48Address ("00:00:00:00:00:01"));
+  dataHdr.SetAddr3 (Mac48Address ("00:00:00:00:00:01"));
+  Ptr<Packet> data = Create<Packet> (50);
+  data->AddHeader (dataHdr);
+  Ptr<WifiSpectrumSignalParameters> dataParams = DynamicCast<WifiSpectrumSignalParameters> (params->Copy ());
+  dataParams->packet = data;
+
+  Simulator::Schedule (MilliSeconds (1), &CoexistenceSpectrumChannel::StartTx, channel, dataParams);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNBeaconDeliveries (), 2, "a data frame counted as a beacon");
+  NS_TEST_ASSERT_MSG_EQ (culledPhy->GetReceivedSignals ().size (), 1, "data frame not received by the culled receiver");
+  NS_TEST_ASSERT_MSG_EQ (decodingPhy->GetReceivedSignals ().size (), 2, "data frame not received by the decoding receiver");
+
+  Simulator::Destroy ();
+}
@@ -0,0 +1,151 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TEST_COEXISTENCE_SPECTRUM_CHANNEL_H
+#define TEST_COEXISTENCE_SPECTRUM_CHANNEL_H
+
+#include "ns3/test.h"
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/coexistence-spectrum-channel.h>
+#include <vector>
+
+
+using namespace ns3;
+
+
+/**
+ * Test the delivery modes of CoexistenceSpectrumChannel.
+ */
+class CoexistenceSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  CoexistenceSpectrumChannelTestSuite ();
+};
+
+
+/**
+ * A SpectrumPhy which is neither an LTE nor a Wi-Fi PHY, and records
+ * the signals it receives.
+ */
+class CoexistenceTestSpectrumPhy : public SpectrumPhy
+{
+public:
+  /**
+   * \param model the SpectrumModel of the receiver
+   */
+  CoexistenceTestSpectrumPhy (Ptr<const SpectrumModel> model);
+  virtual ~CoexistenceTestSpectrumPhy ();
+
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d);
+  virtual Ptr<NetDevice> GetDevice ();
+  virtual void SetMobility (Ptr<MobilityModel> m);
+  virtual Ptr<MobilityModel> GetMobility ();
+  virtual void SetChannel (Ptr<SpectrumChannel> c);
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  virtual Ptr<AntennaModel> GetRxAntenna ();
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  /// \return the signals received so far
+  const std::vector<Ptr<SpectrumSignalParameters> > & GetReceivedSignals (void) const;
+
+private:
+  Ptr<const SpectrumModel> m_model; ///< the SpectrumModel of the receiver
+  Ptr<NetDevice> m_device; ///< the device, if any
+  Ptr<MobilityModel> m_mobility; ///< the mobility, if any
+  std::vector<Ptr<SpectrumSignalParameters> > m_received; ///< the signals received
+};
+
+
+/**
+ * In the reduced-signalling mode, send an LTE DL control frame with a
+ * DL DCI and the data frame of the same subframe, with the timing of
+ * the LTE PHY, and check the energy seen by a non-LTE receiver: the
+ * energy of the control frame must be folded into the data frame if
+ * the data frame starts within the tolerance, and be dropped otherwise.
+ */
+class CoexistenceCtrlFoldTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test
+   * \param gap the time between the end of the control frame and the
+   * start of the data frame
+   * \param folded whether the control frame is expected to be folded
+   */
+  CoexistenceCtrlFoldTestCase (std::string name, Time gap, bool folded);
+  virtual ~CoexistenceCtrlFoldTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  Time m_gap; ///< the time between the control frame and the data frame
+  bool m_folded; ///< whether the control frame is expected to be folded
+};
+
+/**
+ * In the reduced-signalling mode, send an LTE DL control frame without
+ * a DL DCI, which the LTE PHY does not follow with a data frame, and
+ * check that a non-LTE receiver gets it with its full energy.
+ */
+class CoexistenceCtrlWithoutDataTestCase : public TestCase
+{
+public:
+  CoexistenceCtrlWithoutDataTestCase ();
+  virtual ~CoexistenceCtrlWithoutDataTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+/**
+ * Restrict the cells measured by a receiver with SetMeasuredCells (),
+ * send LTE DL control frames carrying the PSS of a cell it measures
+ * and of one it does not, and check that the PSS of the latter is
+ * hidden from it only.
+ */
+class CoexistenceMeasuredCellsTestCase : public TestCase
+{
+public:
+  CoexistenceMeasuredCellsTestCase ();
+  virtual ~CoexistenceMeasuredCellsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+/**
+ * In the beacon-culling mode, send a Wi-Fi beacon to a receiver
+ * registered with SetBeaconCulling () and to one which is not, and
+ * check that only the second one receives it, unchanged; a broadcast
+ * data frame must still reach both receivers.
+ */
+class CoexistenceBeaconCullingTestCase : public TestCase
+{
+public:
+  CoexistenceBeaconCullingTestCase ();
+  virtual ~CoexistenceBeaconCullingTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+#endif /* TEST_COEXISTENCE_SPECTRUM_CHANNEL_H */
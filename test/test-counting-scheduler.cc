@@ -0,0 +1,105 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+#include "test-counting-scheduler.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestCountingScheduler");
+
+
+/**
+ * TestSuite
+ */
+
+CountingSchedulerTestSuite::CountingSchedulerTestSuite ()
+  : TestSuite ("laa-counting-scheduler", UNIT)
+{
+  AddTestCase (new CountingSchedulerTestCase ("ns3::MapScheduler"), TestCase::QUICK);
+  AddTestCase (new CountingSchedulerTestCase ("ns3::HeapScheduler"), TestCase::QUICK);
+  AddTestCase (new CountingSchedulerTestCase ("ns3::ListScheduler"), TestCase::QUICK);
+  // the scheduler selected by the SchedulerType global value
+  AddTestCase (new CountingSchedulerTestCase (""), TestCase::QUICK);
+}
+
+static CountingSchedulerTestSuite countingSchedulerTestSuite;
+
+
+/**
+ * TestCase
+ */
+
+CountingSchedulerTestCase::CountingSchedulerTestCase (std::string schedulerType)
+  : TestCase ("counters with " + (schedulerType.empty () ? std::string ("the default scheduler") : schedulerType)),
+    m_schedulerType (schedulerType)
+{
+}
+
+CountingSchedulerTestCase::~CountingSchedulerTestCase ()
+{
+}
+
+Scheduler::Event
+CountingSchedulerTestCase::MakeTestEvent (uint64_t ts, uint32_t uid)
+{
+  Scheduler::Event ev;
+  ev.impl = 0;
+  ev.key.m_ts = ts;
+  ev.key.m_uid = uid;
+  ev.key.m_context = 0;
+  return ev;
+}
+
+void
+CountingSchedulerTestCase::DoRun (void)
+{
+  Ptr<CountingScheduler> scheduler = CreateObject<CountingScheduler> ();
+  scheduler->SetAttribute ("SchedulerType", StringValue (m_schedulerType));
+  CountingScheduler::ResetCounters ();
+
+  scheduler->Insert (MakeTestEvent (10, 2));
+  scheduler->Insert (MakeTestEvent (20, 4));
+  scheduler->Insert (MakeTestEvent (5, 1));
+  scheduler->Insert (MakeTestEvent (20, 5));
+  scheduler->Insert (MakeTestEvent (10, 3));
+  scheduler->Remove (MakeTestEvent (20, 5));
+
+  const uint32_t expectedUids[] = {1, 2, 3, 4};
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), false, "scheduler empty too early");
+      NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, expectedUids[i], "wrong next event");
+      NS_TEST_ASSERT_MSG_EQ (scheduler->RemoveNext ().key.m_uid, expectedUids[i], "wrong event removed");
+    }
+  NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), true, "scheduler not empty");
+
+  NS_TEST_ASSERT_MSG_EQ (CountingScheduler::GetNInserts (), 5, "wrong number of insertions");
+  NS_TEST_ASSERT_MSG_EQ (CountingScheduler::GetNRemoves (), 1, "wrong number of cancelled events");
+  NS_TEST_ASSERT_MSG_EQ (CountingScheduler::GetNRemoveNexts (), 4, "wrong number of executed events");
+  // the second event at 10
+  NS_TEST_ASSERT_MSG_EQ (CountingScheduler::GetNSameTimeEvents (), 1, "wrong number of same-time events");
+  NS_TEST_ASSERT_MSG_EQ (CountingScheduler::GetMaxSize (), 5, "wrong maximum size");
+
+  scheduler->Dispose ();
+}
@@ -0,0 +1,64 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TEST_COUNTING_SCHEDULER_H
+#define TEST_COUNTING_SCHEDULER_H
+
+#include "ns3/test.h"
+#include <ns3/counting-scheduler.h>
+
+
+using namespace ns3;
+
+
+/**
+ * Test the event order and the counters of CountingScheduler.
+ */
+class CountingSchedulerTestSuite : public TestSuite
+{
+public:
+  CountingSchedulerTestSuite ();
+};
+
+
+/**
+ * Insert, cancel and remove events with a given wrapped Scheduler, and
+ * check the order in which they come out and the counters.
+ */
+class CountingSchedulerTestCase : public TestCase
+{
+public:
+  CountingSchedulerTestCase (std::string schedulerType);
+  virtual ~CountingSchedulerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param ts the time stamp of the event
+   * \param uid the UID of the event
+   * \return an event without implementation
+   */
+  static Scheduler::Event MakeTestEvent (uint64_t ts, uint32_t uid);
+
+  std::string m_schedulerType; ///< the type of the wrapped Scheduler
+};
+
+#endif /* TEST_COUNTING_SCHEDULER_H */
@@ -0,0 +1,152 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/rng-seed-manager.h"
+#include <ns3/node-container.h>
+#include <ns3/yans-wifi-helper.h>
+#include <ns3/ht-wifi-mac-helper.h>
+#include <ns3/wifi-helper.h>
+#include <ns3/ssid.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/vector.h>
+#include <cstdlib>
+#include <sstream>
+
+#include "test-full-buffer-wifi-source.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestFullBufferWifiSource");
+
+
+/**
+ * TestSuite
+ */
+
+FullBufferWifiSourceTestSuite::FullBufferWifiSourceTestSuite ()
+  : TestSuite ("laa-full-buffer-wifi-source", UNIT)
+{
+  AddTestCase (new FullBufferWifiSourceTestCase (), TestCase::QUICK);
+}
+
+static FullBufferWifiSourceTestSuite fullBufferWifiSourceTestSuite;
+
+
+/**
+ * TestCase
+ */
+
+static const uint32_t N_STAS = 3;
+
+FullBufferWifiSourceTestCase::FullBufferWifiSourceTestCase ()
+  : TestCase ("saturated AP")
+{
+}
+
+FullBufferWifiSourceTestCase::~FullBufferWifiSourceTestCase ()
+{
+}
+
+void
+FullBufferWifiSourceTestCase::Associated (std::string context, Mac48Address ap)
+{
+  uint32_t i = std::atoi (context.c_str ());
+  m_source->AddDestination (DynamicCast<WifiNetDevice> (m_staDevices.Get (i)));
+}
+
+void
+FullBufferWifiSourceTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  NodeContainer apNode;
+  apNode.Create (1);
+  NodeContainer staNodes;
+  staNodes.Create (N_STAS);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 0));
+  for (uint32_t i = 0; i < N_STAS; ++i)
+    {
+      positions->Add (Vector (5, i, 0));
+    }
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (apNode);
+  mobility.Install (staNodes);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::IdealWifiManager");
+  HtWifiMacHelper mac = HtWifiMacHelper::Default ();
+  mac.SetBlockAckThresholdForAc (AC_BE, 2);
+  mac.SetMpduAggregatorForAc (AC_BE, "ns3::MpduStandardAggregator");
+  Ssid ssid ("full-buffer");
+  mac.SetType ("ns3::ApWifiMac",
+               "Ssid", SsidValue (ssid));
+  NetDeviceContainer apDevice = wifi.Install (phy, mac, apNode);
+  mac.SetType ("ns3::StaWifiMac",
+               "Ssid", SsidValue (ssid),
+               "ActiveProbing", BooleanValue (false));
+  m_staDevices = wifi.Install (phy, mac, staNodes);
+
+  m_source = CreateObject<FullBufferWifiSource> ();
+  m_source->SetDevice (DynamicCast<WifiNetDevice> (apDevice.Get (0)));
+  apNode.Get (0)->AddApplication (m_source);
+  m_source->SetStartTime (Seconds (1));
+  m_source->SetStopTime (Seconds (2));
+  for (uint32_t i = 0; i < N_STAS; ++i)
+    {
+      std::ostringstream context;
+      context << i;
+      DynamicCast<WifiNetDevice> (m_staDevices.Get (i))->GetMac ()->TraceConnect ("Assoc", context.str (), MakeCallback (&FullBufferWifiSourceTestCase::Associated, this));
+    }
+
+  // the queue is still backlogged when the source stops, and what is
+  // received afterwards is not counted
+  Simulator::Stop (Seconds (2.5));
+  Simulator::Run ();
+
+  uint64_t totalRxBytes = 0;
+  for (uint32_t i = 0; i < N_STAS; ++i)
+    {
+      uint64_t rxBytes = m_source->GetRxBytes (Mac48Address::ConvertFrom (m_staDevices.Get (i)->GetAddress ()));
+      NS_TEST_ASSERT_MSG_GT (rxBytes, 0, "STA " << i << " received nothing");
+      totalRxBytes += rxBytes;
+    }
+  NS_TEST_ASSERT_MSG_GT (m_source->GetNSent (), totalRxBytes / 1000, "more packets received than sent");
+  // MCS 7 with a single stream is 65 Mb/s; A-MPDUs with block ack
+  // deliver most of it
+  double throughputMbps = totalRxBytes * 8.0 / 1e6;
+  NS_TEST_ASSERT_MSG_GT (throughputMbps, 20, "the AP is not saturated");
+  NS_TEST_ASSERT_MSG_LT (throughputMbps, 65, "bytes received after the source stopped are counted");
+
+  Simulator::Destroy ();
+  m_source = 0;
+  m_staDevices = NetDeviceContainer ();
+}
@@ -0,0 +1,71 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TEST_FULL_BUFFER_WIFI_SOURCE_H
+#define TEST_FULL_BUFFER_WIFI_SOURCE_H
+
+#include "ns3/test.h"
+#include <ns3/full-buffer-wifi-source.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/net-device-container.h>
+
+
+using namespace ns3;
+
+
+/**
+ * Test the full-buffer Wi-Fi source.
+ */
+class FullBufferWifiSourceTestSuite : public TestSuite
+{
+public:
+  FullBufferWifiSourceTestSuite ();
+};
+
+
+/**
+ * An 802.11n AP with a FullBufferWifiSource serving a few STAs close
+ * to it, which become destinations when they associate: check that
+ * every STA receives traffic, that the aggregate throughput is close
+ * to the capacity of the link, and that only the bytes received while
+ * the source runs are counted.
+ */
+class FullBufferWifiSourceTestCase : public TestCase
+{
+public:
+  FullBufferWifiSourceTestCase ();
+  virtual ~FullBufferWifiSourceTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Add a STA to the destinations of the source
+   *
+   * \param context the index of the STA
+   * \param ap the address of the AP
+   */
+  void Associated (std::string context, Mac48Address ap);
+
+  Ptr<FullBufferWifiSource> m_source; ///< the source
+  NetDeviceContainer m_staDevices; ///< the devices of the STAs
+};
+
+#endif /* TEST_FULL_BUFFER_WIFI_SOURCE_H */
@@ -0,0 +1,281 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/pf-ff-mac-scheduler.h>
+#include <ns3/lte-fr-no-op-algorithm.h>
+#include <ns3/incremental-pf-ff-mac-scheduler.h>
+
+#include "test-incremental-pf-ff-mac-scheduler.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestIncrementalPfFfMacScheduler");
+
+
+namespace {
+
+/**
+ * A scheduler on a cell without the rest of the LTE stack, which keeps
+ * the DL allocations of the last TTI
+ */
+class SchedulerUnderTest : public FfMacCschedSapUser, public FfMacSchedSapUser
+{
+public:
+  /**
+   * Configure the cell of a scheduler
+   *
+   * \param scheduler the scheduler
+   * \param bandwidth the DL and UL bandwidth in RBs
+   */
+  SchedulerUnderTest (Ptr<FfMacScheduler> scheduler, uint8_t bandwidth);
+  virtual ~SchedulerUnderTest ();
+
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    m_dataList = params.m_buildDataList;
+  }
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+  {
+  }
+
+  Ptr<FfMacScheduler> m_scheduler; ///< the scheduler
+  Ptr<LteFfrAlgorithm> m_ffr; ///< the frequency reuse algorithm, which reuses all the RBs
+  std::vector<BuildDataListElement_s> m_dataList; ///< the DL allocations of the last TTI
+};
+
+SchedulerUnderTest::SchedulerUnderTest (Ptr<FfMacScheduler> scheduler, uint8_t bandwidth)
+  : m_scheduler (scheduler)
+{
+  m_ffr = CreateObject<LteFrNoOpAlgorithm> ();
+  m_ffr->SetDlBandwidth (bandwidth);
+  m_ffr->SetUlBandwidth (bandwidth);
+  m_ffr->SetLteFfrSapUser (scheduler->GetLteFfrSapUser ());
+  scheduler->SetLteFfrSapProvider (m_ffr->GetLteFfrSapProvider ());
+  scheduler->SetFfMacCschedSapUser (this);
+  scheduler->SetFfMacSchedSapUser (this);
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cell;
+  cell.m_dlBandwidth = bandwidth;
+  cell.m_ulBandwidth = bandwidth;
+  scheduler->GetFfMacCschedSapProvider ()->CschedCellConfigReq (cell);
+}
+
+SchedulerUnderTest::~SchedulerUnderTest ()
+{
+  m_scheduler->Dispose ();
+  m_ffr->Dispose ();
+}
+
+} // anonymous namespace
+
+
+/**
+ * TestSuite
+ */
+
+IncrementalPfFfMacSchedulerTestSuite::IncrementalPfFfMacSchedulerTestSuite ()
+  : TestSuite ("laa-incremental-pf-ff-mac-scheduler", UNIT)
+{
+  AddTestCase (new IncrementalPfFfMacSchedulerTestCase (10), TestCase::QUICK);
+  AddTestCase (new IncrementalPfFfMacSchedulerTestCase (30), TestCase::QUICK);
+}
+
+static IncrementalPfFfMacSchedulerTestSuite incrementalPfFfMacSchedulerTestSuite;
+
+
+/**
+ * TestCase
+ */
+
+IncrementalPfFfMacSchedulerTestCase::IncrementalPfFfMacSchedulerTestCase (uint16_t nUes)
+  : TestCase ("same DL allocations as PfFfMacScheduler"),
+    m_nUes (nUes)
+{
+}
+
+IncrementalPfFfMacSchedulerTestCase::~IncrementalPfFfMacSchedulerTestCase ()
+{
+}
+
+void
+IncrementalPfFfMacSchedulerTestCase::DoRun (void)
+{
+  const uint8_t bandwidth = 100;
+  const uint32_t rbgNum = 25;
+  // the DL averages are rescaled after about 22700 TTIs
+  const uint32_t nTtis = 25000;
+
+  Ptr<FfMacScheduler> pf = CreateObject<PfFfMacScheduler> ();
+  Ptr<FfMacScheduler> incremental = CreateObject<IncrementalPfFfMacScheduler> ();
+  Ptr<FfMacScheduler> both[2] = { pf, incremental };
+  for (uint32_t s = 0; s < 2; ++s)
+    {
+      // without HARQ, no feedback has to be faked; the CQIs expire often
+      both[s]->SetAttribute ("HarqEnabled", BooleanValue (false));
+      both[s]->SetAttribute ("CqiTimerThreshold", UintegerValue (20));
+    }
+  SchedulerUnderTest pfUnderTest (pf, bandwidth);
+  SchedulerUnderTest incrementalUnderTest (incremental, bandwidth);
+  std::vector<SchedulerUnderTest *> schedulers;
+  schedulers.push_back (&pfUnderTest);
+  schedulers.push_back (&incrementalUnderTest);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<uint16_t> rntis;
+  uint16_t nextRnti = 1;
+  for (uint32_t tti = 0; tti < nTtis; ++tti)
+    {
+      // a UE leaves and another one arrives now and then
+      std::vector<uint16_t> newRntis;
+      if (tti == 0)
+        {
+          while (nextRnti <= m_nUes)
+            {
+              newRntis.push_back (nextRnti++);
+            }
+        }
+      else if (tti % 1000 == 0)
+        {
+          FfMacCschedSapProvider::CschedUeReleaseReqParameters release;
+          release.m_rnti = rntis.front ();
+          rntis.erase (rntis.begin ());
+          for (uint32_t s = 0; s < schedulers.size (); ++s)
+            {
+              schedulers[s]->m_scheduler->GetFfMacCschedSapProvider ()->CschedUeReleaseReq (release);
+            }
+          newRntis.push_back (nextRnti++);
+        }
+      for (uint32_t i = 0; i < newRntis.size (); ++i)
+        {
+          FfMacCschedSapProvider::CschedUeConfigReqParameters ue;
+          ue.m_rnti = newRntis[i];
+          // some UEs with two layers
+          ue.m_transmissionMode = (ue.m_rnti % 4 == 0) ? 2 : 0;
+          FfMacCschedSapProvider::CschedLcConfigReqParameters lc;
+          lc.m_rnti = ue.m_rnti;
+          lc.m_reconfigureFlag = false;
+          LogicalChannelConfigListElement_s lcConfig;
+          lcConfig.m_logicalChannelIdentity = 3;
+          lcConfig.m_logicalChannelGroup = 1;
+          lcConfig.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+          lcConfig.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+          lcConfig.m_qci = 9;
+          lc.m_logicalChannelConfigList.push_back (lcConfig);
+          for (uint32_t s = 0; s < schedulers.size (); ++s)
+            {
+              schedulers[s]->m_scheduler->GetFfMacCschedSapProvider ()->CschedUeConfigReq (ue);
+              schedulers[s]->m_scheduler->GetFfMacCschedSapProvider ()->CschedLcConfigReq (lc);
+            }
+          rntis.push_back (ue.m_rnti);
+        }
+
+      // new RLC buffer reports, some of them empty, and subband CQIs,
+      // some of them out of range
+      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiReport;
+      cqiReport.m_sfnSf = ((1 + tti / 10) << 4) | (1 + tti % 10);
+      for (uint32_t i = 0; i < rntis.size (); ++i)
+        {
+          if (random->GetValue () < 0.3)
+            {
+              FfMacSchedSapProvider::SchedDlRlcBufferReqParameters buffer;
+              buffer.m_rnti = rntis[i];
+              buffer.m_logicalChannelIdentity = 3;
+              buffer.m_rlcTransmissionQueueSize = (random->GetValue () < 0.2) ? 0 : random->GetInteger (1, 3000);
+              buffer.m_rlcTransmissionQueueHolDelay = 0;
+              buffer.m_rlcRetransmissionQueueSize = 0;
+              buffer.m_rlcRetransmissionHolDelay = 0;
+              buffer.m_rlcStatusPduSize = 0;
+              for (uint32_t s = 0; s < schedulers.size (); ++s)
+                {
+                  schedulers[s]->m_scheduler->GetFfMacSchedSapProvider ()->SchedDlRlcBufferReq (buffer);
+                }
+            }
+          if (random->GetValue () < 0.1)
+            {
+              CqiListElement_s cqi;
+              cqi.m_rnti = rntis[i];
+              cqi.m_ri = 1;
+              cqi.m_cqiType = CqiListElement_s::A30;
+              for (uint32_t j = 0; j < rbgNum; ++j)
+                {
+                  HigherLayerSelected_s subband;
+                  subband.m_sbCqi.push_back (random->GetInteger (0, 15));
+                  subband.m_sbCqi.push_back (random->GetInteger (0, 15));
+                  cqi.m_sbMeasResult.m_higherLayerSelected.push_back (subband);
+                }
+              cqiReport.m_cqiList.push_back (cqi);
+            }
+        }
+
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters trigger;
+      trigger.m_sfnSf = cqiReport.m_sfnSf;
+      for (uint32_t s = 0; s < schedulers.size (); ++s)
+        {
+          if (!cqiReport.m_cqiList.empty ())
+            {
+              schedulers[s]->m_scheduler->GetFfMacSchedSapProvider ()->SchedDlCqiInfoReq (cqiReport);
+            }
+          schedulers[s]->m_dataList.clear ();
+          schedulers[s]->m_scheduler->GetFfMacSchedSapProvider ()->SchedDlTriggerReq (trigger);
+        }
+
+      const std::vector<BuildDataListElement_s> &expected = schedulers[0]->m_dataList;
+      const std::vector<BuildDataListElement_s> &actual = schedulers[1]->m_dataList;
+      NS_TEST_ASSERT_MSG_EQ (actual.size (), expected.size (), "wrong number of UEs served in TTI " << tti);
+      for (uint32_t k = 0; k < actual.size (); ++k)
+        {
+          const DlDciListElement_s &dci = actual[k].m_dci;
+          const DlDciListElement_s &expectedDci = expected[k].m_dci;
+          NS_TEST_ASSERT_MSG_EQ (actual[k].m_rnti, expected[k].m_rnti, "wrong UE served in TTI " << tti);
+          NS_TEST_ASSERT_MSG_EQ (dci.m_rbBitmap, expectedDci.m_rbBitmap, "wrong RBGs in TTI " << tti);
+          NS_TEST_ASSERT_MSG_EQ (dci.m_mcs.size (), expectedDci.m_mcs.size (), "wrong number of layers in TTI " << tti);
+          for (uint32_t j = 0; j < dci.m_mcs.size (); ++j)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((uint16_t) dci.m_mcs[j], (uint16_t) expectedDci.m_mcs[j], "wrong MCS in TTI " << tti);
+              NS_TEST_ASSERT_MSG_EQ (dci.m_tbsSize[j], expectedDci.m_tbsSize[j], "wrong TB size in TTI " << tti);
+            }
+        }
+    }
+}
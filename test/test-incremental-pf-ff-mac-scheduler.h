@@ -0,0 +1,61 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TEST_INCREMENTAL_PF_FF_MAC_SCHEDULER_H
+#define TEST_INCREMENTAL_PF_FF_MAC_SCHEDULER_H
+
+#include "ns3/test.h"
+
+
+using namespace ns3;
+
+
+/**
+ * Test the incremental proportional fair scheduler against the one of
+ * the LTE module.
+ */
+class IncrementalPfFfMacSchedulerTestSuite : public TestSuite
+{
+public:
+  IncrementalPfFfMacSchedulerTestSuite ();
+};
+
+
+/**
+ * Drive PfFfMacScheduler and IncrementalPfFfMacScheduler through their
+ * SAPs with the same RLC buffer reports, subband CQIs and UE arrivals and
+ * releases, and check that they make the same DL allocations in every
+ * TTI, over enough TTIs for the stored averages to be rescaled.
+ */
+class IncrementalPfFfMacSchedulerTestCase : public TestCase
+{
+public:
+  /**
+   * \param nUes the number of UEs
+   */
+  IncrementalPfFfMacSchedulerTestCase (uint16_t nUes);
+  virtual ~IncrementalPfFfMacSchedulerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  uint16_t m_nUes; ///< the number of UEs
+};
+
+#endif /* TEST_INCREMENTAL_PF_FF_MAC_SCHEDULER_H */
@@ -0,0 +1,136 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-mi-cache.h>
+#include <cmath>
+
+#include "test-lte-mi-cache.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestLteMiCache");
+
+
+/**
+ * TestSuite
+ */
+
+LteMiCacheTestSuite::LteMiCacheTestSuite ()
+  : TestSuite ("laa-lte-mi-cache", UNIT)
+{
+  AddTestCase (new LteMiCacheTestCase (), TestCase::QUICK);
+}
+
+static LteMiCacheTestSuite lteMiCacheTestSuite;
+
+
+/**
+ * TestCase
+ */
+
+LteMiCacheTestCase::LteMiCacheTestCase ()
+  : TestCase ("memoized MI and CQI vs LTE module")
+{
+}
+
+LteMiCacheTestCase::~LteMiCacheTestCase ()
+{
+}
+
+void
+LteMiCacheTestCase::DoRun (void)
+{
+  const double q = 0.1;
+  Ptr<SpectrumModel> model = LteSpectrumValueHelper::GetSpectrumModel (255444, 100);
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+
+  // SINR exactly on the quantization grid, between -5 and 25 dB
+  SpectrumValue onGrid (model);
+  std::vector<int> map;
+  for (uint32_t rb = 0; rb < 100; ++rb)
+    {
+      int32_t level = -50 + (rb * 7) % 300;
+      onGrid[rb] = std::pow (10.0, level * q / 10.0);
+      if (rb % 2 == 0)
+        {
+          map.push_back (rb);
+        }
+    }
+  // the same SINR, off by less than half a step
+  SpectrumValue offGrid (onGrid);
+  offGrid *= std::pow (10.0, 0.3 * q / 10.0);
+
+  HarqProcessInfoList_t noHistory;
+  uint8_t mcs = 15;
+  uint16_t tbSize = 2000;
+
+  Ptr<LteMiCache> exact = Create<LteMiCache> (0.0);
+  Ptr<LteMiCache> cache = Create<LteMiCache> (q);
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (exact->Mib (offGrid, map, mcs), LteMiErrorModel::Mib (offGrid, map, mcs),
+                             "exact mode differs from LteMiErrorModel");
+      NS_TEST_ASSERT_MSG_EQ (cache->Mib (onGrid, map, mcs), LteMiErrorModel::Mib (onGrid, map, mcs),
+                             "cached MI differs from LteMiErrorModel");
+      NS_TEST_ASSERT_MSG_EQ (cache->Mib (offGrid, map, mcs), LteMiErrorModel::Mib (onGrid, map, mcs),
+                             "SINR within the same step not mapped to the same MI");
+
+      TbStats_t expected = LteMiErrorModel::GetTbDecodificationStats (onGrid, map, tbSize, mcs, noHistory);
+      TbStats_t actual = cache->GetTbDecodificationStats (offGrid, map, tbSize, mcs, noHistory);
+      NS_TEST_ASSERT_MSG_EQ (actual.tbler, expected.tbler, "wrong cached TBLER");
+      NS_TEST_ASSERT_MSG_EQ (actual.mi, expected.mi, "wrong cached MI");
+
+      std::vector<int> expectedCqi = amc->CreateCqiFeedbacks (onGrid);
+      std::vector<int> cqi = cache->CreateCqiFeedbacks (amc, offGrid);
+      NS_TEST_ASSERT_MSG_EQ (cqi.size (), expectedCqi.size (), "wrong number of CQIs");
+      for (uint32_t rb = 0; rb < cqi.size (); ++rb)
+        {
+          NS_TEST_ASSERT_MSG_EQ (cqi[rb], expectedCqi[rb], "wrong cached CQI for RB " << rb);
+        }
+    }
+
+  // the first round computes the MI, the TB stats and the CQIs; all the
+  // other lookups are hits
+  NS_TEST_ASSERT_MSG_EQ (cache->GetMisses (), 3u, "wrong number of misses");
+  NS_TEST_ASSERT_MSG_EQ (cache->GetHits (), 9u, "wrong number of hits");
+  NS_TEST_ASSERT_MSG_EQ (exact->GetHits (), 0u, "the exact mode should never hit");
+
+  // one step more on a single RB of the TB is a different key
+  SpectrumValue otherSinr (onGrid);
+  otherSinr[map.back ()] *= std::pow (10.0, q / 10.0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (cache->Mib (otherSinr, map, mcs), LteMiErrorModel::Mib (otherSinr, map, mcs), 1e-12,
+                             "wrong MI for a SINR differing on one RB");
+  NS_TEST_ASSERT_MSG_EQ (cache->GetMisses (), 4u, "a SINR differing on one RB should miss");
+  // the RBs out of the TB are not part of the key
+  otherSinr[1] *= 10;
+  cache->Mib (otherSinr, map, mcs);
+  NS_TEST_ASSERT_MSG_EQ (cache->GetHits (), 10u, "the RBs out of the TB should not be part of the key");
+
+  // the hit rate estimate counts a SINR within the same steps as a hit,
+  // without computing the CQIs
+  Ptr<LteMiCache> estimate = Create<LteMiCache> (q);
+  estimate->CountCqiLookup (onGrid);
+  estimate->CountCqiLookup (offGrid);
+  estimate->CountCqiLookup (otherSinr);
+  NS_TEST_ASSERT_MSG_EQ (estimate->GetHits (), 1u, "wrong number of estimated hits");
+  NS_TEST_ASSERT_MSG_EQ (estimate->GetMisses (), 2u, "wrong number of estimated misses");
+}
@@ -0,0 +1,54 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TEST_LTE_MI_CACHE_H
+#define TEST_LTE_MI_CACHE_H
+
+#include "ns3/test.h"
+
+
+using namespace ns3;
+
+
+/**
+ * Test the memo cache of the LTE MI error model and CQI generation.
+ */
+class LteMiCacheTestSuite : public TestSuite
+{
+public:
+  LteMiCacheTestSuite ();
+};
+
+
+/**
+ * Check that the exact mode gives the same results as the LTE module,
+ * that SINRs on the quantization grid give the same results as well,
+ * and that SINRs within the same quantization step hit the cache.
+ */
+class LteMiCacheTestCase : public TestCase
+{
+public:
+  LteMiCacheTestCase ();
+  virtual ~LteMiCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+#endif /* TEST_LTE_MI_CACHE_H */
@@ -46,6 +46,8 @@
 
 #include "test-lte-unlicensed-interference.h"
 
+#include <list>
+
 
 using namespace ns3;
 
@@ -102,6 +104,21 @@ LteUnlicensedInterferenceTestSuite::LteUnlicensedInterferenceTestSuite ()
   AddTestCase (new LteUnlicensedInterferenceTestCase ("d1=20, d2=20",  20.000000, 20.000000,  0.999989, 0.999941,  0.239826, 0.239816, 2, 2), TestCase::QUICK);
   AddTestCase (new LteUnlicensedInterferenceTestCase ("d1=20, d2=50",  20.000000, 50.000000,  6.249581, 6.247687,  1.091025, 1.090793, 8, 8), TestCase::QUICK);
   AddTestCase (new LteUnlicensedInterferenceTestCase ("d1=20, d2=200",  20.000000, 200.000000,  99.892921, 99.411076,  4.252922, 4.246313, 22, 22), TestCase::QUICK);
+
+  // the same cases with ns3::CoexistenceSpectrumChannel; the flat
+  // FriisPropagationLossModel exercises the path where the PSD is
+  // scaled only when the signal reaches the receiver
+  std::list<std::string> pathlossModels;
+  pathlossModels.push_back ("ns3::FriisSpectrumPropagationLossModel");
+  pathlossModels.push_back ("ns3::FriisPropagationLossModel");
+  for (std::list<std::string>::const_iterator it = pathlossModels.begin (); it != pathlossModels.end (); ++it)
+    {
+      std::string channelType = "ns3::CoexistenceSpectrumChannel";
+      std::string suffix = ", " + channelType + ", " + *it;
+      AddTestCase (new LteUnlicensedInterferenceTestCase ("d1=20, d2=20" + suffix,  20.000000, 20.000000,  0.999989, 0.999941,  0.239826, 0.239816, 2, 2, channelType, *it), TestCase::QUICK);
+      AddTestCase (new LteUnlicensedInterferenceTestCase ("d1=20, d2=50" + suffix,  20.000000, 50.000000,  6.249581, 6.247687,  1.091025, 1.090793, 8, 8, channelType, *it), TestCase::QUICK);
+      AddTestCase (new LteUnlicensedInterferenceTestCase ("d1=20, d2=200" + suffix,  20.000000, 200.000000,  99.892921, 99.411076,  4.252922, 4.246313, 22, 22, channelType, *it), TestCase::QUICK);
+    }
 }
 
 static LteUnlicensedInterferenceTestSuite lteLinkAdaptationWithInterferenceTestSuite;
@@ -118,7 +135,22 @@ LteUnlicensedInterferenceTestCase::LteUnlicensedInterferenceTestCase (std::strin
     m_expectedDlSinrDb (10 * std::log10 (dlSinr)),
     m_expectedUlSinrDb (10 * std::log10 (ulSinr)),
     m_dlMcs (dlMcs),
-    m_ulMcs (ulMcs)
+    m_ulMcs (ulMcs),
+    m_channelType ("ns3::MultiModelSpectrumChannel"),
+    m_pathlossModel ("ns3::FriisSpectrumPropagationLossModel")
+{
+}
+
+LteUnlicensedInterferenceTestCase::LteUnlicensedInterferenceTestCase (std::string name, double d1, double d2, double dlSinr, double ulSinr, double dlSe, double ulSe, uint16_t dlMcs, uint16_t ulMcs, std::string channelType, std::string pathlossModel)
+  : TestCase (name),
+    m_d1 (d1),
+    m_d2 (d2),
+    m_expectedDlSinrDb (10 * std::log10 (dlSinr)),
+    m_expectedUlSinrDb (10 * std::log10 (ulSinr)),
+    m_dlMcs (dlMcs),
+    m_ulMcs (ulMcs),
+    m_channelType (channelType),
+    m_pathlossModel (pathlossModel)
 {
 }
 
@@ -142,9 +174,10 @@ LteUnlicensedInterferenceTestCase::DoRun (void)
 
 
   Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
-  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+  lteHelper->SetAttribute ("PathlossModel", StringValue (m_pathlossModel));
   lteHelper->SetAttribute ("UseIdealRrc", BooleanValue (false));
   lteHelper->SetAttribute ("UsePdschForCqiGeneration", BooleanValue (true));
+  lteHelper->SetSpectrumChannelType (m_channelType);
 
   //Disable Uplink Power Control
   Config::SetDefault ("ns3::LteUePhy::EnableUplinkPowerControl", BooleanValue (false));
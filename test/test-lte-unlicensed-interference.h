@@ -42,6 +42,7 @@ class LteUnlicensedInterferenceTestCase : public TestCase
 {
 public:
   LteUnlicensedInterferenceTestCase (std::string name, double d1, double d2, double dlSinr, double ulSinr, double dlSe, double ulSe, uint16_t dlMcs, uint16_t ulMcs);
+  LteUnlicensedInterferenceTestCase (std::string name, double d1, double d2, double dlSinr, double ulSinr, double dlSe, double ulSe, uint16_t dlMcs, uint16_t ulMcs, std::string channelType, std::string pathlossModel);
   virtual ~LteUnlicensedInterferenceTestCase ();
 
   void DlScheduling (uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
@@ -60,6 +61,8 @@ private:
   double m_expectedUlSinrDb;
   uint16_t m_dlMcs;
   uint16_t m_ulMcs;
+  std::string m_channelType;
+  std::string m_pathlossModel;
 };
 
 #endif /* LTE_TEST_UNLICENSED_INTERFERENCE_H */
@@ -0,0 +1,150 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include <ns3/node.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+
+#include "test-mmap-trace-fading.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestMmapTraceFading");
+
+/// number of points of the frequency grid of the test trace
+static const uint32_t N_FREQUENCIES = 4;
+/// number of samples of the test trace
+static const uint32_t N_SAMPLES = 10;
+
+
+/**
+ * TestSuite
+ */
+
+MmapTraceFadingTestSuite::MmapTraceFadingTestSuite ()
+  : TestSuite ("laa-mmap-trace-fading", UNIT)
+{
+  AddTestCase (new MmapTraceFadingTestCase (), TestCase::QUICK);
+}
+
+static MmapTraceFadingTestSuite mmapTraceFadingTestSuite;
+
+
+/**
+ * TestCase
+ */
+
+MmapTraceFadingTestCase::MmapTraceFadingTestCase ()
+  : TestCase ("gains read from a memory-mapped trace")
+{
+}
+
+MmapTraceFadingTestCase::~MmapTraceFadingTestCase ()
+{
+}
+
+double
+MmapTraceFadingTestCase::GetTraceGainDb (uint32_t f, uint32_t t)
+{
+  return -0.1 * (10 * f + t);
+}
+
+void
+MmapTraceFadingTestCase::CheckGains (Ptr<MobilityModel> a, Ptr<MobilityModel> b)
+{
+  uint32_t offset = m_fading->GetLinkOffset (a, b);
+  NS_TEST_ASSERT_MSG_EQ (offset, m_fading->GetLinkOffset (b, a), "the link offset depends on the direction");
+  NS_TEST_ASSERT_MSG_LT (offset, N_SAMPLES, "link offset beyond the end of the trace");
+
+  uint32_t sample = (Simulator::Now ().GetMilliSeconds () + offset) % N_SAMPLES;
+  Ptr<SpectrumValue> rxPsd = m_fading->CalcRxPowerSpectralDensity (m_txPsd, a, b);
+  for (uint32_t f = 0; f < N_FREQUENCIES; ++f)
+    {
+      double expected = static_cast<float> (std::pow (10.0, GetTraceGainDb (f, sample) / 10.0));
+      NS_TEST_ASSERT_MSG_EQ ((*rxPsd)[f], expected, "wrong gain for band " << f << " at " << Simulator::Now ().GetSeconds ());
+    }
+}
+
+void
+MmapTraceFadingTestCase::DoRun (void)
+{
+  // ASCII trace in the format of the LTE TraceFadingLossModel: one
+  // line per frequency, one value in dB per 1 ms sample
+  std::string asciiFile = CreateTempDirFilename ("laa-fading-trace.txt");
+  std::string traceFile = CreateTempDirFilename ("laa-fading-trace.bin");
+  std::ofstream ascii (asciiFile.c_str ());
+  ascii.precision (17);
+  for (uint32_t f = 0; f < N_FREQUENCIES; ++f)
+    {
+      for (uint32_t t = 0; t < N_SAMPLES; ++t)
+        {
+          ascii << GetTraceGainDb (f, t) << " ";
+        }
+      ascii << std::endl;
+    }
+  ascii.close ();
+  bool written = MmapTraceFadingLossModel::WriteTraceFile (asciiFile, traceFile, N_FREQUENCIES, N_SAMPLES,
+                                                           MilliSeconds (1), 5170e6, 5e6);
+  NS_TEST_ASSERT_MSG_EQ (written, true, "could not write the trace file");
+
+  // the four 5 MHz bands of Wi-Fi channel 36, one per grid point
+  Bands bands;
+  for (uint32_t f = 0; f < N_FREQUENCIES; ++f)
+    {
+      BandInfo bandInfo;
+      bandInfo.fl = 5170e6 + f * 5e6;
+      bandInfo.fh = bandInfo.fl + 5e6;
+      bandInfo.fc = bandInfo.fl + 2.5e6;
+      bands.push_back (bandInfo);
+    }
+  m_txPsd = Create<SpectrumValue> (Create<SpectrumModel> (bands));
+  *m_txPsd = 1.0;
+
+  m_fading = CreateObject<MmapTraceFadingLossModel> ();
+  m_fading->SetAttribute ("TraceFilename", StringValue (traceFile));
+
+  Ptr<MobilityModel> mobility[3];
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      mobility[i] = CreateObject<ConstantPositionMobilityModel> ();
+      node->AggregateObject (mobility[i]);
+    }
+
+  // within the trace, and after it wraps around
+  Time times[] = { MilliSeconds (0), MicroSeconds (3500), MilliSeconds (12), MilliSeconds (29) };
+  for (uint32_t i = 0; i < sizeof (times) / sizeof (times[0]); ++i)
+    {
+      Simulator::Schedule (times[i], &MmapTraceFadingTestCase::CheckGains, this, mobility[0], mobility[1]);
+      Simulator::Schedule (times[i], &MmapTraceFadingTestCase::CheckGains, this, mobility[2], mobility[1]);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_fading->Dispose ();
+  m_fading = 0;
+  std::remove (asciiFile.c_str ());
+  std::remove (traceFile.c_str ());
+}
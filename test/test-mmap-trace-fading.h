@@ -0,0 +1,69 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TEST_MMAP_TRACE_FADING_H
+#define TEST_MMAP_TRACE_FADING_H
+
+#include "ns3/test.h"
+#include <ns3/mobility-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/mmap-trace-fading-loss-model.h>
+
+
+using namespace ns3;
+
+
+/**
+ * Test the trace-driven fading model.
+ */
+class MmapTraceFadingTestSuite : public TestSuite
+{
+public:
+  MmapTraceFadingTestSuite ();
+};
+
+
+/**
+ * Convert a small ASCII trace, and check that the gain applied to each
+ * band is the one of the trace at the right frequency and time, for a
+ * link offset that does not depend on the direction of the link.
+ */
+class MmapTraceFadingTestCase : public TestCase
+{
+public:
+  MmapTraceFadingTestCase ();
+  virtual ~MmapTraceFadingTestCase ();
+
+  void CheckGains (Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param f the frequency index
+   * \param t the time sample
+   * \return the gain of the test trace, in dB
+   */
+  static double GetTraceGainDb (uint32_t f, uint32_t t);
+
+  Ptr<MmapTraceFadingLossModel> m_fading;
+  Ptr<SpectrumValue> m_txPsd;
+};
+
+#endif /* TEST_MMAP_TRACE_FADING_H */
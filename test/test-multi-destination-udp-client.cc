@@ -0,0 +1,163 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include <ns3/node-container.h>
+#include <ns3/point-to-point-helper.h>
+#include <ns3/internet-stack-helper.h>
+#include <ns3/ipv4-address-helper.h>
+#include <ns3/udp-client-server-helper.h>
+#include <ns3/udp-server.h>
+#include <sstream>
+
+#include "test-multi-destination-udp-client.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestMultiDestinationUdpClient");
+
+
+/**
+ * TestSuite
+ */
+
+MultiDestinationUdpClientTestSuite::MultiDestinationUdpClientTestSuite ()
+  : TestSuite ("laa-multi-destination-udp-client", UNIT)
+{
+  AddTestCase (new MultiDestinationUdpClientTestCase ("all packets sent", 20, Seconds (1)), TestCase::QUICK);
+  AddTestCase (new MultiDestinationUdpClientTestCase ("stopped while sending", 100, MilliSeconds (95)), TestCase::QUICK);
+}
+
+static MultiDestinationUdpClientTestSuite multiDestinationUdpClientTestSuite;
+
+
+/**
+ * TestCase
+ */
+
+static const uint32_t N_SERVERS = 3;
+
+MultiDestinationUdpClientTestCase::MultiDestinationUdpClientTestCase (std::string name, uint32_t maxPackets, Time duration)
+  : TestCase (name),
+    m_maxPackets (maxPackets),
+    m_duration (duration)
+{
+}
+
+MultiDestinationUdpClientTestCase::~MultiDestinationUdpClientTestCase ()
+{
+}
+
+void
+MultiDestinationUdpClientTestCase::RunScenario (bool aggregated, std::vector<uint32_t> &received, std::vector<uint32_t> &lost)
+{
+  NodeContainer client;
+  client.Create (1);
+  NodeContainer servers;
+  servers.Create (N_SERVERS);
+  InternetStackHelper internet;
+  internet.Install (client);
+  internet.Install (servers);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  Ipv4AddressHelper ipv4;
+  std::vector<Ipv4Address> serverAddresses;
+  for (uint32_t i = 0; i < N_SERVERS; ++i)
+    {
+      NetDeviceContainer devices = p2p.Install (client.Get (0), servers.Get (i));
+      std::ostringstream network;
+      network << "10.1." << i + 1 << ".0";
+      ipv4.SetBase (network.str ().c_str (), "255.255.255.0");
+      serverAddresses.push_back (ipv4.Assign (devices).GetAddress (1));
+    }
+
+  uint16_t port = 9;
+  UdpServerHelper serverHelper (port);
+  ApplicationContainer serverApps = serverHelper.Install (servers);
+  serverApps.Start (Seconds (0.5));
+  serverApps.Stop (Seconds (5));
+
+  ApplicationContainer clientApps;
+  if (aggregated)
+    {
+      Ptr<MultiDestinationUdpClient> app = CreateObject<MultiDestinationUdpClient> ();
+      app->SetAttribute ("MaxPackets", UintegerValue (m_maxPackets));
+      app->SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+      app->SetAttribute ("PacketSize", UintegerValue (1000));
+      app->SetAttribute ("RemotePort", UintegerValue (port));
+      for (uint32_t i = 0; i < N_SERVERS; ++i)
+        {
+          app->AddDestination (serverAddresses[i]);
+        }
+      client.Get (0)->AddApplication (app);
+      clientApps.Add (app);
+    }
+  else
+    {
+      UdpClientHelper clientHelper (Address (), 0);
+      clientHelper.SetAttribute ("MaxPackets", UintegerValue (m_maxPackets));
+      clientHelper.SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+      clientHelper.SetAttribute ("PacketSize", UintegerValue (1000));
+      clientHelper.SetAttribute ("RemotePort", UintegerValue (port));
+      for (uint32_t i = 0; i < N_SERVERS; ++i)
+        {
+          clientHelper.SetAttribute ("RemoteAddress", AddressValue (serverAddresses[i]));
+          clientApps.Add (clientHelper.Install (client));
+        }
+    }
+  clientApps.Start (Seconds (1));
+  clientApps.Stop (Seconds (1) + m_duration);
+
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+  received.clear ();
+  lost.clear ();
+  for (uint32_t i = 0; i < N_SERVERS; ++i)
+    {
+      Ptr<UdpServer> server = DynamicCast<UdpServer> (serverApps.Get (i));
+      received.push_back (server->GetReceived ());
+      lost.push_back (server->GetLost ());
+    }
+  Simulator::Destroy ();
+}
+
+void
+MultiDestinationUdpClientTestCase::DoRun (void)
+{
+  std::vector<uint32_t> expectedReceived;
+  std::vector<uint32_t> expectedLost;
+  RunScenario (false, expectedReceived, expectedLost);
+  std::vector<uint32_t> received;
+  std::vector<uint32_t> lost;
+  RunScenario (true, received, lost);
+  for (uint32_t i = 0; i < N_SERVERS; ++i)
+    {
+      NS_TEST_ASSERT_MSG_GT (expectedReceived[i], 0, "no packets received by server " << i);
+      NS_TEST_ASSERT_MSG_EQ (received[i], expectedReceived[i], "wrong number of packets received by server " << i);
+      NS_TEST_ASSERT_MSG_EQ (lost[i], expectedLost[i], "wrong number of packets lost by server " << i);
+      NS_TEST_ASSERT_MSG_EQ (lost[i], 0, "packets lost by server " << i);
+    }
+}
@@ -0,0 +1,76 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TEST_MULTI_DESTINATION_UDP_CLIENT_H
+#define TEST_MULTI_DESTINATION_UDP_CLIENT_H
+
+#include "ns3/test.h"
+#include <ns3/multi-destination-udp-client.h>
+#include <vector>
+
+
+using namespace ns3;
+
+
+/**
+ * Test that MultiDestinationUdpClient generates the same traffic as a
+ * UdpClient per destination.
+ */
+class MultiDestinationUdpClientTestSuite : public TestSuite
+{
+public:
+  MultiDestinationUdpClientTestSuite ();
+};
+
+
+/**
+ * Send UDP traffic from a node to UdpServers on a few nodes, connected
+ * to it by point-to-point links, once with a UdpClient per destination
+ * and once with a MultiDestinationUdpClient, and check that each
+ * server receives the same packets, without losses, in both cases.
+ */
+class MultiDestinationUdpClientTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test
+   * \param maxPackets the MaxPackets attribute of the clients
+   * \param duration the time between the start and the stop of the clients
+   */
+  MultiDestinationUdpClientTestCase (std::string name, uint32_t maxPackets, Time duration);
+  virtual ~MultiDestinationUdpClientTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario
+   *
+   * \param aggregated whether to use a MultiDestinationUdpClient
+   * \param received the packets received by each server
+   * \param lost the packets lost by each server
+   */
+  void RunScenario (bool aggregated, std::vector<uint32_t> &received, std::vector<uint32_t> &lost);
+
+  uint32_t m_maxPackets; ///< the MaxPackets attribute of the clients
+  Time m_duration; ///< the time between the start and the stop of the clients
+};
+
+#endif /* TEST_MULTI_DESTINATION_UDP_CLIENT_H */
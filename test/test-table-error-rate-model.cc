@@ -0,0 +1,251 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include <ns3/wifi-phy.h>
+#include <ns3/nist-error-rate-model.h>
+#include <ns3/table-error-rate-model.h>
+#include <cmath>
+#include <cstdio>
+
+#include "test-table-error-rate-model.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestTableErrorRateModel");
+
+
+/**
+ * TestSuite
+ */
+
+TableErrorRateModelTestSuite::TableErrorRateModelTestSuite ()
+  : TestSuite ("laa-table-error-rate-model", UNIT)
+{
+  // HT MCS 0, 3 and 7
+  AddTestCase (new TableErrorRateModelAccuracyTestCase (WifiPhy::GetOfdmRate6_5MbpsBW20MHz ()), TestCase::QUICK);
+  AddTestCase (new TableErrorRateModelAccuracyTestCase (WifiPhy::GetOfdmRate26MbpsBW20MHz ()), TestCase::QUICK);
+  AddTestCase (new TableErrorRateModelAccuracyTestCase (WifiPhy::GetOfdmRate65MbpsBW20MHz ()), TestCase::QUICK);
+  AddTestCase (new TableErrorRateModelFileTestCase (), TestCase::QUICK);
+  AddTestCase (new TableErrorRateModelFrameSyncTestCase (), TestCase::QUICK);
+}
+
+static TableErrorRateModelTestSuite tableErrorRateModelTestSuite;
+
+
+/**
+ * Accuracy TestCase
+ */
+
+TableErrorRateModelAccuracyTestCase::TableErrorRateModelAccuracyTestCase (WifiMode mode)
+  : TestCase ("table vs NistErrorRateModel, " + mode.GetUniqueName ()),
+    m_mode (mode)
+{
+}
+
+TableErrorRateModelAccuracyTestCase::~TableErrorRateModelAccuracyTestCase ()
+{
+}
+
+void
+TableErrorRateModelAccuracyTestCase::DoRun (void)
+{
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+
+  // SNRs not aligned with the grid, short chunks and full frames
+  for (double snrDb = -2.0; snrDb < 35.0; snrDb += 0.37)
+    {
+      double snr = std::pow (10.0, snrDb / 10.0);
+      for (uint32_t nbits = 100; nbits <= 12000; nbits *= 3)
+        {
+          double expected = nist->GetChunkSuccessRate (m_mode, snr, nbits);
+          double actual = table->GetChunkSuccessRate (m_mode, snr, nbits);
+          NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, 0.01, "wrong chunk success rate at " << snrDb << " dB with " << nbits << " bits");
+        }
+    }
+
+  // above the SNR at which the sampled BER rounds to zero, the BER
+  // stays at the last sample instead of dropping towards a floor
+  double previousBer = 1.0;
+  for (double snrDb = -5.0; snrDb <= 40.0; snrDb += 0.013)
+    {
+      double ber = table->GetBer (m_mode, std::pow (10.0, snrDb / 10.0));
+      NS_TEST_ASSERT_MSG_GT (ber, 1e-17, "BER interpolated towards the floor at " << snrDb << " dB");
+      NS_TEST_ASSERT_MSG_LT (ber, previousBer * (1 + 1e-9), "BER increasing at " << snrDb << " dB");
+      previousBer = ber;
+    }
+
+  // below the grid, nothing better than a random guess
+  for (double snrDb = -20.0; snrDb < -5.0; snrDb += 1.1)
+    {
+      double ber = table->GetBer (m_mode, std::pow (10.0, snrDb / 10.0));
+      NS_TEST_ASSERT_MSG_GT (ber, 0.5 - 1e-12, "BER lower than 0.5 below the grid at " << snrDb << " dB");
+    }
+  NS_TEST_ASSERT_MSG_GT (table->GetBer (m_mode, 0.0), 0.5 - 1e-12, "BER lower than 0.5 for a null SNR");
+}
+
+
+/**
+ * File TestCase
+ */
+
+TableErrorRateModelFileTestCase::TableErrorRateModelFileTestCase ()
+  : TestCase ("tables saved to and mapped from a file")
+{
+}
+
+TableErrorRateModelFileTestCase::~TableErrorRateModelFileTestCase ()
+{
+}
+
+void
+TableErrorRateModelFileTestCase::DoRun (void)
+{
+  std::string tableFile = CreateTempDirFilename ("laa-error-rate-tables.bin");
+  std::remove (tableFile.c_str ());
+
+  WifiMode modes[] = { WifiPhy::GetOfdmRate6_5MbpsBW20MHz (),
+                       WifiPhy::GetOfdmRate39MbpsBW20MHz (),
+                       WifiPhy::GetOfdmRate58_5MbpsBW20MHz () };
+  const uint32_t nModes = sizeof (modes) / sizeof (modes[0]);
+
+  // the first instance computes the tables and saves them
+  Ptr<TableErrorRateModel> writer = CreateObject<TableErrorRateModel> ();
+  writer->SetAttribute ("TableFile", StringValue (tableFile));
+  Ptr<TableErrorRateModel> inMemory = CreateObject<TableErrorRateModel> ();
+  for (uint32_t m = 0; m < nModes; ++m)
+    {
+      writer->GetBer (modes[m], 1.0);
+    }
+
+  // once it is gone, a new instance maps them from the file
+  writer->Dispose ();
+  writer = 0;
+  Ptr<TableErrorRateModel> reader = CreateObject<TableErrorRateModel> ();
+  reader->SetAttribute ("TableFile", StringValue (tableFile));
+  for (uint32_t m = 0; m < nModes; ++m)
+    {
+      for (double snrDb = 0.0; snrDb < 30.0; snrDb += 0.53)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          NS_TEST_ASSERT_MSG_EQ (reader->GetBer (modes[m], snr), inMemory->GetBer (modes[m], snr),
+                                 "mapped table differs from computed one at " << snrDb << " dB");
+        }
+    }
+
+  reader->Dispose ();
+  std::remove (tableFile.c_str ());
+
+  // two processes loading the file before either saves to it: the
+  // second to save merges the table of the first
+  const uint32_t nPoints = 10;
+  Ptr<ErrorRateTableSet> first = Create<ErrorRateTableSet> (tableFile, 0.0, 1.0, nPoints);
+  Ptr<ErrorRateTableSet> second = Create<ErrorRateTableSet> (tableFile, 0.0, 1.0, nPoints);
+  first->Add (1, std::vector<double> (nPoints, -1.0));
+  second->Add (2, std::vector<double> (nPoints, -2.0));
+  Ptr<ErrorRateTableSet> merged = Create<ErrorRateTableSet> (tableFile, 0.0, 1.0, nPoints);
+  NS_TEST_ASSERT_MSG_EQ ((merged->Find (1) != 0), true, "table saved by the first process lost");
+  NS_TEST_ASSERT_MSG_EQ ((merged->Find (2) != 0), true, "table saved by the second process lost");
+  if (merged->Find (1) != 0 && merged->Find (2) != 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (merged->Find (1)[nPoints - 1], -1.0, "wrong merged table");
+      NS_TEST_ASSERT_MSG_EQ (merged->Find (2)[nPoints - 1], -2.0, "wrong merged table");
+    }
+  std::remove (tableFile.c_str ());
+  std::remove ((tableFile + ".lock").c_str ());
+}
+
+
+/**
+ * Frame sync TestCase
+ */
+
+TableErrorRateModelFrameSyncTestCase::TableErrorRateModelFrameSyncTestCase ()
+  : TestCase ("frame sync error rate table")
+{
+}
+
+TableErrorRateModelFrameSyncTestCase::~TableErrorRateModelFrameSyncTestCase ()
+{
+}
+
+void
+TableErrorRateModelFrameSyncTestCase::DoRun (void)
+{
+  std::string tableFile = CreateTempDirFilename ("laa-frame-sync-tables.bin");
+  std::remove (tableFile.c_str ());
+
+  // a curve with points on and off the SNR grid
+  double points[][2] = { { -3.0, 1.0 }, { 0.0, 0.5 }, { 1.23, 0.1 }, { 5.0, 0.0 } };
+  const uint32_t nPoints = sizeof (points) / sizeof (points[0]);
+  std::vector<double> sinrDb;
+  std::vector<double> errorRate;
+  for (uint32_t j = 0; j < nPoints; ++j)
+    {
+      sinrDb.push_back (points[j][0]);
+      errorRate.push_back (points[j][1]);
+    }
+
+  Ptr<TableErrorRateModel> writer = CreateObject<TableErrorRateModel> ();
+  writer->SetAttribute ("TableFile", StringValue (tableFile));
+  writer->SetFrameSyncCurve (sinrDb, errorRate);
+  for (double snrDb = -10.0; snrDb < 10.0; snrDb += 0.17)
+    {
+      // linear interpolation between the points of the curve
+      double expected;
+      if (snrDb <= points[0][0])
+        {
+          expected = points[0][1];
+        }
+      else if (snrDb >= points[nPoints - 1][0])
+        {
+          expected = points[nPoints - 1][1];
+        }
+      else
+        {
+          uint32_t j = 1;
+          while (points[j][0] < snrDb)
+            {
+              ++j;
+            }
+          double f = (snrDb - points[j - 1][0]) / (points[j][0] - points[j - 1][0]);
+          expected = points[j - 1][1] + f * (points[j][1] - points[j - 1][1]);
+        }
+      // up to the error of sampling the curve every 0.05 dB around a
+      // point off the grid
+      double actual = writer->GetFrameSyncErrorRate (std::pow (10.0, snrDb / 10.0));
+      NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, 0.02, "wrong frame sync error rate at " << snrDb << " dB");
+    }
+
+  // a new instance without a curve maps it from the file
+  double snr = std::pow (10.0, 0.61 / 10.0);
+  double expected = writer->GetFrameSyncErrorRate (snr);
+  writer->Dispose ();
+  writer = 0;
+  Ptr<TableErrorRateModel> reader = CreateObject<TableErrorRateModel> ();
+  reader->SetAttribute ("TableFile", StringValue (tableFile));
+  NS_TEST_ASSERT_MSG_EQ (reader->GetFrameSyncErrorRate (snr), expected, "mapped frame sync table differs");
+
+  reader->Dispose ();
+  std::remove (tableFile.c_str ());
+  std::remove ((tableFile + ".lock").c_str ());
+}
@@ -0,0 +1,87 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TEST_TABLE_ERROR_RATE_MODEL_H
+#define TEST_TABLE_ERROR_RATE_MODEL_H
+
+#include "ns3/test.h"
+#include <ns3/wifi-mode.h>
+
+
+using namespace ns3;
+
+
+/**
+ * Test the lookup-table Wi-Fi error rate model.
+ */
+class TableErrorRateModelTestSuite : public TestSuite
+{
+public:
+  TableErrorRateModelTestSuite ();
+};
+
+
+/**
+ * Compare the chunk success rate of TableErrorRateModel with the one
+ * of the NistErrorRateModel it is built from.
+ */
+class TableErrorRateModelAccuracyTestCase : public TestCase
+{
+public:
+  TableErrorRateModelAccuracyTestCase (WifiMode mode);
+  virtual ~TableErrorRateModelAccuracyTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  WifiMode m_mode;
+};
+
+
+/**
+ * Check that the tables saved to a file and mapped back by another
+ * instance give the same results as the tables computed in memory, and
+ * that the tables saved by two sets loaded before either saved are
+ * merged in the file.
+ */
+class TableErrorRateModelFileTestCase : public TestCase
+{
+public:
+  TableErrorRateModelFileTestCase ();
+  virtual ~TableErrorRateModelFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+/**
+ * Check that the frame sync error rate interpolates the curve set, and
+ * that a new instance without a curve maps it from the file.
+ */
+class TableErrorRateModelFrameSyncTestCase : public TestCase
+{
+public:
+  TableErrorRateModelFrameSyncTestCase ();
+  virtual ~TableErrorRateModelFrameSyncTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+#endif /* TEST_TABLE_ERROR_RATE_MODEL_H */
@@ -0,0 +1,121 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "ns3/log.h"
+#include "ns3/rng-seed-manager.h"
+#include <ns3/yans-wifi-phy.h>
+#include <ns3/nist-error-rate-model.h>
+#include <ns3/random-variable-stream.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "test-threshold-ideal-wifi-manager.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestThresholdIdealWifiManager");
+
+
+/**
+ * TestSuite
+ */
+
+ThresholdIdealWifiManagerTestSuite::ThresholdIdealWifiManagerTestSuite ()
+  : TestSuite ("laa-threshold-ideal-wifi-manager", UNIT)
+{
+  AddTestCase (new ThresholdIdealWifiManagerTestCase ("slow SNR changes", 0.5), TestCase::QUICK);
+  AddTestCase (new ThresholdIdealWifiManagerTestCase ("fast SNR changes", 10), TestCase::QUICK);
+}
+
+static ThresholdIdealWifiManagerTestSuite thresholdIdealWifiManagerTestSuite;
+
+
+/**
+ * TestCase
+ */
+
+static const uint32_t N_STATIONS = 4;
+static const uint32_t N_REPORTS = 5000;
+
+ThresholdIdealWifiManagerTestCase::ThresholdIdealWifiManagerTestCase (std::string name, double snrStepDb)
+  : TestCase (name),
+    m_snrStepDb (snrStepDb)
+{
+}
+
+ThresholdIdealWifiManagerTestCase::~ThresholdIdealWifiManagerTestCase ()
+{
+}
+
+void
+ThresholdIdealWifiManagerTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+
+  Ptr<ThresholdIdealWifiManager> manager = CreateObject<ThresholdIdealWifiManager> ();
+  Ptr<IdealWifiManager> reference = CreateObject<IdealWifiManager> ();
+  manager->SetupPhy (phy);
+  reference->SetupPhy (phy);
+
+  // station i supports the modes of the PHY with index multiple of i + 1
+  std::vector<Mac48Address> stations;
+  for (uint32_t i = 0; i < N_STATIONS; ++i)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      stations.push_back (address);
+      for (uint32_t m = 0; m < phy->GetNModes (); m += i + 1)
+        {
+          manager->AddSupportedMode (address, phy->GetMode (m));
+          reference->AddSupportedMode (address, phy->GetMode (m));
+        }
+    }
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  Ptr<Packet> packet = Create<Packet> (1500);
+  std::vector<double> snrDb (N_STATIONS, 15.0);
+  for (uint32_t k = 0; k < N_REPORTS; ++k)
+    {
+      uint32_t i = random->GetInteger (0, N_STATIONS - 1);
+      WifiMacHeader hdr;
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetAddr1 (stations[i]);
+      hdr.SetQosTid (0);
+      snrDb[i] = std::max (-5.0, std::min (40.0, snrDb[i] + random->GetValue (-m_snrStepDb, m_snrStepDb)));
+      double snr = std::pow (10.0, snrDb[i] / 10.0);
+      WifiMode ackMode = phy->GetMode (0);
+      manager->ReportDataOk (stations[i], &hdr, snr, ackMode, snr);
+      reference->ReportDataOk (stations[i], &hdr, snr, ackMode, snr);
+      WifiMode mode = manager->GetDataTxVector (stations[i], &hdr, packet, packet->GetSize ()).GetMode ();
+      WifiMode expected = reference->GetDataTxVector (stations[i], &hdr, packet, packet->GetSize ()).GetMode ();
+      NS_TEST_ASSERT_MSG_EQ (mode, expected, "wrong data mode for station " << i << " at SNR " << snrDb[i] << " dB");
+      mode = manager->GetRtsTxVector (stations[i], &hdr, packet).GetMode ();
+      expected = reference->GetRtsTxVector (stations[i], &hdr, packet).GetMode ();
+      NS_TEST_ASSERT_MSG_EQ (mode, expected, "wrong RTS mode for station " << i << " at SNR " << snrDb[i] << " dB");
+    }
+  NS_TEST_ASSERT_MSG_EQ (manager->GetNDataDecisions (), N_REPORTS, "wrong number of decisions");
+  NS_TEST_ASSERT_MSG_LT (manager->GetNSearches (), manager->GetNDataDecisions (), "the cached mode has never been used");
+}
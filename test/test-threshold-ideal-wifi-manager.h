@@ -0,0 +1,67 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TEST_THRESHOLD_IDEAL_WIFI_MANAGER_H
+#define TEST_THRESHOLD_IDEAL_WIFI_MANAGER_H
+
+#include "ns3/test.h"
+#include <ns3/threshold-ideal-wifi-manager.h>
+#include <ns3/ideal-wifi-manager.h>
+
+
+using namespace ns3;
+
+
+/**
+ * Test that ThresholdIdealWifiManager selects the same modes as
+ * IdealWifiManager.
+ */
+class ThresholdIdealWifiManagerTestSuite : public TestSuite
+{
+public:
+  ThresholdIdealWifiManagerTestSuite ();
+};
+
+
+/**
+ * Report the same random sequence of data SNRs to a
+ * ThresholdIdealWifiManager and to an IdealWifiManager, for a few
+ * stations supporting all the modes of an 802.11n PHY or only some of
+ * them, and check that the data and RTS modes are the same after every
+ * report. The SNR follows a random walk in dB, whose step sets how
+ * often the cached mode can be reused.
+ */
+class ThresholdIdealWifiManagerTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test
+   * \param snrStepDb the maximum change of the SNR between two reports
+   */
+  ThresholdIdealWifiManagerTestCase (std::string name, double snrStepDb);
+  virtual ~ThresholdIdealWifiManagerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  double m_snrStepDb; ///< the maximum change of the SNR between two reports
+};
+
+#endif /* TEST_THRESHOLD_IDEAL_WIFI_MANAGER_H */
@@ -0,0 +1,126 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "ns3/log.h"
+#include "ns3/map-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include <map>
+
+#include "test-timing-wheel-scheduler.h"
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestTimingWheelScheduler");
+
+
+/**
+ * TestSuite
+ */
+
+TimingWheelSchedulerTestSuite::TimingWheelSchedulerTestSuite ()
+  : TestSuite ("laa-timing-wheel-scheduler", UNIT)
+{
+  AddTestCase (new TimingWheelSchedulerTestCase ("default slot width", NanoSeconds (16384)), TestCase::QUICK);
+  AddTestCase (new TimingWheelSchedulerTestCase ("1 ns slots", NanoSeconds (1)), TestCase::QUICK);
+  AddTestCase (new TimingWheelSchedulerTestCase ("1 ms slots", MilliSeconds (1)), TestCase::QUICK);
+}
+
+static TimingWheelSchedulerTestSuite timingWheelSchedulerTestSuite;
+
+
+/**
+ * TestCase
+ */
+
+TimingWheelSchedulerTestCase::TimingWheelSchedulerTestCase (std::string name, Time slotWidth)
+  : TestCase (name),
+    m_slotWidth (slotWidth)
+{
+}
+
+TimingWheelSchedulerTestCase::~TimingWheelSchedulerTestCase ()
+{
+}
+
+void
+TimingWheelSchedulerTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+
+  Ptr<TimingWheelScheduler> wheel = CreateObject<TimingWheelScheduler> ();
+  wheel->SetAttribute ("SlotWidth", TimeValue (m_slotWidth));
+  Ptr<MapScheduler> reference = CreateObject<MapScheduler> ();
+
+  // delays, in ns, of the events inserted
+  const uint64_t delays[] = {0, 0, 1, 1000, 106000, 700000, 1000000, 1000000, 1000000,
+                             102400000, 3000000000ULL, 500000000000ULL, 100000000000000ULL};
+  const uint32_t nDelays = sizeof (delays) / sizeof (delays[0]);
+
+  std::map<uint32_t, Scheduler::Event> queued; // the events in the schedulers, by UID
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  uint32_t nExecuted = 0;
+  for (uint32_t step = 0; step < 200000; ++step)
+    {
+      double action = random->GetValue ();
+      if (action < 0.5 || reference->IsEmpty ())
+        {
+          uint64_t delay = delays[random->GetInteger (0, nDelays - 1)] + random->GetInteger (0, 1) * random->GetInteger (0, 100000);
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key.m_ts = now + delay;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          wheel->Insert (ev);
+          reference->Insert (ev);
+          queued[ev.key.m_uid] = ev;
+        }
+      else if (action < 0.55)
+        {
+          // cancel the most recent event, as Simulator::Remove () does
+          Scheduler::Event ev = queued.rbegin ()->second;
+          queued.erase (ev.key.m_uid);
+          wheel->Remove (ev);
+          reference->Remove (ev);
+        }
+      else
+        {
+          Scheduler::Event expected = reference->RemoveNext ();
+          queued.erase (expected.key.m_uid);
+          NS_TEST_ASSERT_MSG_EQ (wheel->PeekNext ().key.m_uid, expected.key.m_uid, "wrong next event at step " << step);
+          Scheduler::Event ev = wheel->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.key.m_uid, "wrong event removed at step " << step);
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_ts, expected.key.m_ts, "wrong time stamp at step " << step);
+          now = ev.key.m_ts;
+          ++nExecuted;
+        }
+      NS_TEST_ASSERT_MSG_EQ (wheel->IsEmpty (), reference->IsEmpty (), "wrong IsEmpty () at step " << step);
+    }
+  while (!reference->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (wheel->RemoveNext ().key.m_uid, reference->RemoveNext ().key.m_uid, "wrong event while draining");
+    }
+  NS_TEST_ASSERT_MSG_EQ (wheel->IsEmpty (), true, "events left in the wheel");
+  NS_TEST_ASSERT_MSG_GT (nExecuted, 0u, "no event executed");
+}
@@ -0,0 +1,61 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ * Copyright (c) 2015 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef TEST_TIMING_WHEEL_SCHEDULER_H
+#define TEST_TIMING_WHEEL_SCHEDULER_H
+
+#include "ns3/test.h"
+#include <ns3/timing-wheel-scheduler.h>
+
+
+using namespace ns3;
+
+
+/**
+ * Test that TimingWheelScheduler returns the events in the same order
+ * as MapScheduler.
+ */
+class TimingWheelSchedulerTestSuite : public TestSuite
+{
+public:
+  TimingWheelSchedulerTestSuite ();
+};
+
+
+/**
+ * Apply the same random sequence of insertions, removals and
+ * executions to a TimingWheelScheduler with a given slot width and to
+ * a MapScheduler. The delays mix periodic values (1 ms, 102.4 ms),
+ * events at the current time, and delays beyond the range of the
+ * wheel, so that all the levels and the overflow list are used.
+ */
+class TimingWheelSchedulerTestCase : public TestCase
+{
+public:
+  TimingWheelSchedulerTestCase (std::string name, Time slotWidth);
+  virtual ~TimingWheelSchedulerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  Time m_slotWidth; ///< the slot width of the scheduler under test
+};
+
+#endif /* TEST_TIMING_WHEEL_SCHEDULER_H */